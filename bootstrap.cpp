@@ -0,0 +1,59 @@
+﻿#include "bootstrap.h"
+
+Bootstrap::Bootstrap(ThreadPool& _pool, uint64_t _seed) :
+	pool(_pool), seed(_seed), engines(_pool.getThreads()) {}
+
+ConfidenceInterval Bootstrap::calculateInterval(std::vector<double>::iterator begin, int replicates, double confidence) const {
+	sort(begin, begin + replicates);
+	double alpha = (1 - confidence) / 2;
+	int lower = (int)floor(alpha * (replicates - 1));
+	int upper = (int)ceil((1 - alpha) * (replicates - 1));
+	return { begin[lower], begin[upper] };
+}
+
+template<class T>
+MomentIntervals Bootstrap::calculateIntervals(const BasicEmpiricalDistribution<T>& d, int replicates, double confidence) {
+	if (replicates < 2 || confidence <= 0 || confidence >= 1) {
+		throw 1;
+	}
+	const std::vector<T>& selection = d.getUnsortedSelection();
+	int n = d.getN();
+	double center = d.calculateMathExpectation();
+	estimates.resize(4 * (size_t)replicates);
+
+	pool.parallelFor(replicates, [&](long long r, int worker) {
+		std::mt19937_64& engine = engines[worker];
+		engine.seed(mixRandomSeed(seed, r));
+		std::uniform_int_distribution<int> index(0, n - 1);
+		double s1 = 0, s2 = 0, s3 = 0, s4 = 0;
+		for (int i = 0; i < n; i++) {
+			double y = selection[index(engine)] - center;
+			double y2 = y * y;
+			s1 += y;
+			s2 += y2;
+			s3 += y2 * y;
+			s4 += y2 * y2;
+		}
+		s1 /= n;
+		s2 /= n;
+		s3 /= n;
+		s4 /= n;
+		double m2 = s2 - s1 * s1;
+		double m3 = s3 - 3 * s1 * s2 + 2 * pow(s1, 3);
+		double m4 = s4 - 4 * s1 * s3 + 6 * s1 * s1 * s2 - 3 * pow(s1, 4);
+		estimates[r] = center + s1;
+		estimates[replicates + r] = m2;
+		estimates[2 * (size_t)replicates + r] = m3 / pow(m2, 1.5);
+		estimates[3 * (size_t)replicates + r] = m4 / pow(m2, 2) - 3;
+	}, std::max(1, replicates / (8 * pool.getThreads())));
+
+	MomentIntervals intervals;
+	intervals.mathExpectation = calculateInterval(estimates.begin(), replicates, confidence);
+	intervals.variance = calculateInterval(estimates.begin() + replicates, replicates, confidence);
+	intervals.coeffAsymmetry = calculateInterval(estimates.begin() + 2 * (size_t)replicates, replicates, confidence);
+	intervals.coeffKurtosis = calculateInterval(estimates.begin() + 3 * (size_t)replicates, replicates, confidence);
+	return intervals;
+}
+
+template MomentIntervals Bootstrap::calculateIntervals(const BasicEmpiricalDistribution<double>& d, int replicates, double confidence);
+template MomentIntervals Bootstrap::calculateIntervals(const BasicEmpiricalDistribution<float>& d, int replicates, double confidence);
@@ -0,0 +1,41 @@
+﻿#ifndef __BOOTSTRAP_H
+#define __BOOTSTRAP_H
+
+#include "empirical_dist.h"
+#include "thread_pool.h"
+
+/* Доверительный интервал */
+struct ConfidenceInterval {
+	double lower;
+	double upper;
+};
+
+/* Доверительные интервалы для четырех моментных характеристик */
+struct MomentIntervals {
+	ConfidenceInterval mathExpectation;
+	ConfidenceInterval variance;
+	ConfidenceInterval coeffAsymmetry;
+	ConfidenceInterval coeffKurtosis;
+};
+
+/* Бутстреп-оценка доверительных интервалов для характеристик эмпирического распределения */
+class Bootstrap {
+public:
+	Bootstrap(ThreadPool& _pool, uint64_t _seed = 1);
+
+	/* Вычисление процентильных доверительных интервалов по replicates повторным выборкам */
+	template<class T>
+	MomentIntervals calculateIntervals(const BasicEmpiricalDistribution<T>& d, int replicates, double confidence = 0.95);
+
+private:
+	ThreadPool& pool;
+	uint64_t seed;
+	/* Оценки характеристик по повторным выборкам, переиспользуются между запусками */
+	std::vector<double> estimates;
+	/* Генераторы индексов, по одному на поток пула, перезапускаются для каждой повторной выборки */
+	std::vector<std::mt19937_64> engines;
+	/* Процентильный интервал по отсортированным оценкам */
+	ConfidenceInterval calculateInterval(std::vector<double>::iterator begin, int replicates, double confidence) const;
+};
+
+#endif // !__BOOTSTRAP_H
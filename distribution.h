@@ -3,9 +3,55 @@
 #define _USE_MATH_DEFINES
 
 #include <math.h>
+#include <cmath>
 #include <vector>
 #include <algorithm>
 #include <fstream>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <atomic>
+
+/* Перемешивание зерна seed с номером index (splitmix64) для получения независимых зерен */
+inline uint64_t mixRandomSeed(uint64_t seed, uint64_t index) {
+	uint64_t z = seed + 0x9E3779B97F4A7C15ULL * (index + 1);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/* Генератор псевдослучайных чисел, свой для каждого потока. Заменяет rand(), поэтому srand()
+   на него не влияет: зерно задается setRandomSeed, а без него каждый поток получает свое
+   зерно по порядку первого обращения */
+inline std::mt19937_64& getRandomEngine() {
+	static std::atomic<uint64_t> threads(0);
+	thread_local std::mt19937_64 engine(mixRandomSeed(0, threads++));
+	return engine;
+}
+
+/* Установка зерна генератора текущего потока */
+inline void setRandomSeed(uint64_t seed) {
+	getRandomEngine().seed(seed);
+}
+
+/* Генерация равномерно распределенной случайной величины на полуинтервале [0; 1) */
+inline double getRandomUniform() {
+	return (getRandomEngine()() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/* Моментные характеристики распределения */
+struct Moments {
+	double mathExpectation;
+	double variance;
+	double coeffAsymmetry;
+	double coeffKurtosis;
+};
+
+/* Получение нового номера изменения, уникального в пределах процесса */
+inline uint64_t getNextVersion() {
+	static std::atomic<uint64_t> counter(0);
+	return ++counter;
+}
 
 class IDistribution {
 public:
@@ -21,6 +67,15 @@ public:
 	double virtual calculateCoeffKurtosis() const = 0;
 	/* Вычисление коэффицинта асимметрии */
 	double virtual calculateCoeffAsymmetry() const = 0;
+	/* Номер изменения параметров: новый номер при каждом изменении распределения,
+	   равные номера означают равные параметры. Изменяемые распределения должны его переопределять */
+	uint64_t virtual getVersion() const {
+		return 0;
+	}
+	/* Вычисление всех моментных характеристик за один вызов */
+	Moments virtual calculateMoments() const {
+		return { calculateMathExpectation(), calculateVariance(), calculateCoeffAsymmetry(), calculateCoeffKurtosis() };
+	}
 };
 
 class IPersistent {
@@ -1,108 +1,98 @@
 #include "empirical_dist.h"
 
-int EmpiricalDistribution::calculateK() const {
+template<class T>
+int BasicEmpiricalDistribution<T>::calculateK() const {
 	return (int)ceil(log2(n) + 1);
 }
 
-std::vector<double> EmpiricalDistribution::generateSelection(const IDistribution& d) {
-	std::vector<double> selection;
+template<class T>
+std::vector<T> BasicEmpiricalDistribution<T>::generateSelection(const IDistribution& d) {
+	std::vector<T> selection;
+	selection.reserve(n);
 	for (int i = 0; i < n; i++) {
-		selection.push_back(d.getRandomVariable());
+		selection.push_back((T)d.getRandomVariable());
 	}
-	sort(selection.begin(), selection.end());
 	return selection;
 }
 
-double EmpiricalDistribution::calculateDelta() const {
-	return (1.0 / k) * (selection[n - 1] - selection[0]);
-}
-
-std::vector<double> EmpiricalDistribution::divideSelectionIntoIntervals() const {
-	std::vector<double> boundaries;
-	double next = selection[0];
-	double max = selection[n - 1];
-	double delta = calculateDelta();
-	boundaries.push_back(next);
-	while (next < max) {
-		boundaries.push_back(next + delta);
-		next += delta;
-	}
-	return boundaries;
-}
-
-int EmpiricalDistribution::leftsideBirnarySearch(double min) const {
-	int left = 0;
-	int right = n - 1;
-	while (left + 1 < right) {
-		int midle = left + (right - left) / 2;
-		if (selection[midle] >= min) {
-			right = midle;
+template<class T>
+void BasicEmpiricalDistribution<T>::findExtremes() {
+	minimum = selection[0];
+	maximum = selection[0];
+	for (auto& i : selection) {
+		if (i < minimum) {
+			minimum = i;
 		}
-		else {
-			left = midle;
+		if (i > maximum) {
+			maximum = i;
 		}
 	}
-	if (selection[right] >= min) {
-		return right;
-	}
-	if (selection[left] >= min) {
-		return left;
-	}
-	return -1;
 }
 
-int EmpiricalDistribution::rightsideBirnarySearch(double max) const {
-	int left = 0;
-	int right = n - 1;
-	while (left + 1 < right) {
-		int midle = left + floor((right - left) / 2);
-		if (selection[midle] < max) {
-			left = midle;
-		}
-		else {
-			right = midle;
-		}
+template<class T>
+void BasicEmpiricalDistribution<T>::sortSelection() const {
+	if (isSorted) {
+		return;
 	}
-	if (selection[right] < max) {
-		return right;
+	std::lock_guard<std::mutex> lock(mutex);
+	if (isSorted) {
+		return;
 	}
-	if (selection[left] < max) {
-		return left;
-	}
-	return -1;
+	SelectionAlgorithms::radixSort(selection);
+	isSorted = true;
 }
 
-std::vector<double> EmpiricalDistribution::calculateFrequency() const {
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateDelta() const {
+	return (1.0 / k) * (maximum - minimum);
+}
+
+template<class T>
+std::vector<double> BasicEmpiricalDistribution<T>::divideSelectionIntoIntervals() const {
+	return SelectionAlgorithms::divideIntoIntervals(minimum, maximum, k);
+}
+
+template<class T>
+std::vector<double> BasicEmpiricalDistribution<T>::calculateFrequency() const {
 	std::vector<double> frequencies;
-	int left, right;
-	int ni;
+	int m = boundaries.size() - 1;
+	if (m < 1) {
+		return frequencies;
+	}
+	std::vector<int> counts(m, 0);
 	double delta = calculateDelta();
-	for (int i = 0; i < boundaries.size() - 1; i++) {
-		if (i == 0) {
-			right = rightsideBirnarySearch(boundaries[i + 1]);
-			ni = right + 1;
+	for (auto& x : selection) {
+		int i = (int)((x - minimum) / delta);
+		i = i < 0 ? 0 : (i > m - 1 ? m - 1 : i);
+		while (i > 0 && x < boundaries[i]) {
+			i--;
 		}
-		else if (i == boundaries.size() - 2) {
-			left = leftsideBirnarySearch(boundaries[i]);
-			ni = n - left;
+		while (i < m - 1 && x >= boundaries[i + 1]) {
+			i++;
 		}
-		else {
-			left = leftsideBirnarySearch(boundaries[i]);
-			right = rightsideBirnarySearch(boundaries[i + 1]);
-			ni = right - left + 1;
-		}
-		frequencies.push_back(ni / (n * delta));
+		counts[i]++;
+	}
+	for (int i = 0; i < m; i++) {
+		frequencies.push_back(counts[i] / (n * delta));
 	}
 	return frequencies;
 }
 
-EmpiricalDistribution::EmpiricalDistribution(int _n, const IDistribution& _d, int _k) :
-	n(_n > 1 ? _n : throw 1), k(_k > 1 ? _k : calculateK()), selection(generateSelection(_d)), boundaries(divideSelectionIntoIntervals()), frequencies(calculateFrequency()) {}
+template<class T>
+BasicEmpiricalDistribution<T>::BasicEmpiricalDistribution(int _n, const IDistribution& _d, int _k) :
+	n(_n > 1 ? _n : throw 1), k(_k > 1 ? _k : calculateK()), version(getNextVersion()), selection(generateSelection(_d)), isSorted(false), isHistogramBuilt(false) {
+	findExtremes();
+}
 
 
-EmpiricalDistribution::EmpiricalDistribution(const EmpiricalDistribution& d) {
+template<class T>
+BasicEmpiricalDistribution<T>::BasicEmpiricalDistribution(const BasicEmpiricalDistribution& d) {
 	n = d.n;
 	k = d.k;
+	version = d.version;
+	isSorted = d.isSorted.load();
+	minimum = d.minimum;
+	maximum = d.maximum;
 	for (int i = 0; i < d.selection.size(); i++) {
 		selection.push_back(d.selection[i]);
 	}
@@ -112,15 +102,22 @@ EmpiricalDistribution::EmpiricalDistribution(const EmpiricalDistribution& d) {
 	for (int i = 0; i < d.frequencies.size(); i++) {
 		frequencies.push_back(d.frequencies[i]);
 	}
+	isHistogramBuilt = d.isHistogramBuilt.load();
+	histogramCache = d.histogramCache;
 }
 
-EmpiricalDistribution& EmpiricalDistribution:: operator=(const EmpiricalDistribution& d) {
+template<class T>
+BasicEmpiricalDistribution<T>& BasicEmpiricalDistribution<T>:: operator=(const BasicEmpiricalDistribution& d) {
 	if (this == &d) return *this;
 	selection.clear();
 	frequencies.clear();
 	boundaries.clear();
 	n = d.n;
 	k = d.k;
+	version = d.version;
+	isSorted = d.isSorted.load();
+	minimum = d.minimum;
+	maximum = d.maximum;
 	for (int i = 0; i < d.selection.size(); i++) {
 		selection.push_back(d.selection[i]);
 	}
@@ -130,35 +127,111 @@ EmpiricalDistribution& EmpiricalDistribution:: operator=(const EmpiricalDistribu
 	for (int i = 0; i < d.frequencies.size(); i++) {
 		frequencies.push_back(d.frequencies[i]);
 	}
+	isHistogramBuilt = d.isHistogramBuilt.load();
+	histogramCache = d.histogramCache;
 	return *this;
 }
 
-int EmpiricalDistribution::getN() const {
+template<class T>
+int BasicEmpiricalDistribution<T>::getN() const {
 	return n;
 }
 
-int EmpiricalDistribution::getK() const {
+template<class T>
+int BasicEmpiricalDistribution<T>::getK() const {
 	return k;
 }
 
-std::vector<double> EmpiricalDistribution::getSelection() const {
+template<class T>
+std::vector<T> BasicEmpiricalDistribution<T>::getSelection() const {
+	sortSelection();
 	return selection;
 }
 
-std::vector<double> EmpiricalDistribution::getFrequencies() const {
+template<class T>
+uint64_t BasicEmpiricalDistribution<T>::getVersion() const {
+	return version;
+}
+
+template<class T>
+const std::vector<T>& BasicEmpiricalDistribution<T>::getUnsortedSelection() const {
+	return selection;
+}
+
+template<class T>
+std::vector<double> BasicEmpiricalDistribution<T>::getFrequencies() const {
+	buildHistogram();
 	return frequencies;
 }
 
-void EmpiricalDistribution::setK(int _k) {
+template<class T>
+std::vector<double> BasicEmpiricalDistribution<T>::getBoundaries() const {
+	buildHistogram();
+	return boundaries;
+}
+
+template<class T>
+void BasicEmpiricalDistribution<T>::setK(int _k) {
 	if (_k <= 1) {
 		_k = calculateK();
 	}
+	if (_k == k) {
+		return;
+	}
+	version = getNextVersion();
+	if (isHistogramBuilt) {
+		histogramCache.push_back({ k, std::move(boundaries), std::move(frequencies) });
+		if (histogramCache.size() > histogramCacheSize) {
+			histogramCache.erase(histogramCache.begin());
+		}
+		isHistogramBuilt = false;
+	}
 	k = _k;
+}
+
+template<class T>
+void BasicEmpiricalDistribution<T>::regenerate(int _n, const IDistribution& _d, int _k) {
+	if (_n <= 1) {
+		throw 1;
+	}
+	n = _n;
+	k = _k > 1 ? _k : calculateK();
+	selection.resize(n);
+	for (int i = 0; i < n; i++) {
+		selection[i] = (T)_d.getRandomVariable();
+	}
+	isSorted = false;
+	version = getNextVersion();
+	findExtremes();
+	isHistogramBuilt = false;
+	histogramCache.clear();
+}
+
+template<class T>
+void BasicEmpiricalDistribution<T>::buildHistogram() const {
+	if (isHistogramBuilt) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(mutex);
+	if (isHistogramBuilt) {
+		return;
+	}
+	for (int i = 0; i < histogramCache.size(); i++) {
+		if (histogramCache[i].k == k) {
+			boundaries = std::move(histogramCache[i].boundaries);
+			frequencies = std::move(histogramCache[i].frequencies);
+			histogramCache.erase(histogramCache.begin() + i);
+			isHistogramBuilt = true;
+			return;
+		}
+	}
 	boundaries = divideSelectionIntoIntervals();
 	frequencies = calculateFrequency();
+	isHistogramBuilt = true;
 }
 
-EmpiricalDistribution::EmpiricalDistribution(std::ifstream& file) {
+template<class T>
+BasicEmpiricalDistribution<T>::BasicEmpiricalDistribution(std::ifstream& file) {
 	if (!file.is_open()) {
 		throw 0;
 	}
@@ -171,93 +244,84 @@ EmpiricalDistribution::EmpiricalDistribution(std::ifstream& file) {
 	for (int i = 0; i < n; i++) {
 		double temp;
 		file >> temp;
-		selection.push_back(temp);
+		selection.push_back((T)temp);
 	}
+	isSorted = false;
+	version = getNextVersion();
+	findExtremes();
 	file >> _k;
 	if (_k <= 1) {
 		_k = calculateK();
 	}
 	k = _k;
-	boundaries = divideSelectionIntoIntervals();
-	frequencies = calculateFrequency();
+	isHistogramBuilt = false;
 }
 
-int EmpiricalDistribution::getIndexInterval(double x) const {
-	for (int i = 0; i < boundaries.size() - 1; i++) {
-		if (x >= boundaries[i] && x < boundaries[i + 1]) {
-			return i;
-		}
-	}
-	if (x >= boundaries[boundaries.size() - 2] && x <= boundaries[boundaries.size() - 1]) {
-		return boundaries.size() - 2;
-	}
+template<class T>
+double BasicEmpiricalDistribution<T>::getRandomVariable() const {
+	buildHistogram();
+	return SelectionAlgorithms::generateFromHistogram(boundaries, frequencies);
 }
 
-double EmpiricalDistribution::calculateCumulProb(int k) const {
-	double q = 0;
-	for (int i = 0; i <= k; ++i) {
-		q += frequencies[i];
-	}
-	return q;
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateDensity(double x) const {
+	buildHistogram();
+	int i = SelectionAlgorithms::getIndexInterval(boundaries, x);
+	return i < 0 ? 0 : frequencies[i];
 }
 
-double EmpiricalDistribution::getRandomVariable() const {
-	double r;
-	double topBound = calculateCumulProb(frequencies.size() - 1);
-	do r = (double)rand() / RAND_MAX * topBound;
-	while (r == 0 || r == topBound);
-	for (int i = 0; i < boundaries.size() - 1; ++i) {
-		if (r > calculateCumulProb(i) and r < calculateCumulProb(i + 1)) {
-			do r = (double)rand() / RAND_MAX * (boundaries[i + 1] - boundaries[i]) + boundaries[i + 1];
-			while (r == boundaries[i] || r == boundaries[i + 1]);
-			break;
-		}
-	}
-	return r;
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateMathExpectation() const {
+	return SelectionAlgorithms::calculateMathExpectation(selection.data(), n);
 }
 
-double EmpiricalDistribution::calculateDensity(double x) const {
-	return frequencies[getIndexInterval(x)];
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateVariance() const {
+	return SelectionAlgorithms::calculateVariance(selection.data(), n);
 }
 
-double EmpiricalDistribution::calculateMathExpectation() const {
-	double sum = 0;
-	for (auto& i : selection) {
-		sum += i;
-	}
-	return sum / n;
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateCoeffAsymmetry() const {
+	return SelectionAlgorithms::calculateCoeffAsymmetry(selection.data(), n);
 }
 
-double EmpiricalDistribution::calculateVariance() const {
-	double M = calculateMathExpectation();
-	double sum = 0;
-	for (auto& i : selection) {
-		sum += pow(i - M, 2);
-	}
-	return sum / n;
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateCoeffKurtosis() const {
+	return SelectionAlgorithms::calculateCoeffKurtosis(selection.data(), n);
 }
 
-double EmpiricalDistribution::calculateCoeffAsymmetry() const {
-	double M = calculateMathExpectation();
-	double D = calculateVariance();
-	double sum = 0;
-	for (auto& i : selection) {
-		sum += pow(i - M, 3);
-	}
-	return sum / (n * pow(D, 1.5));
+template<class T>
+Moments BasicEmpiricalDistribution<T>::calculateMoments() const {
+	return SelectionAlgorithms::calculateMoments(selection.data(), n);
 }
 
-double EmpiricalDistribution::calculateCoeffKurtosis() const {
-	double M = calculateMathExpectation();
-	double D = calculateVariance();
-	double sum = 0;
-	for (auto& i : selection) {
-		sum += pow(i - M, 4);
-	}
-	return sum / (n * pow(D, 2)) - 3;
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateDistributionFunction(double x) const {
+	sortSelection();
+	return SelectionAlgorithms::calculateDistributionFunction(selection.data(), n, x);
+}
+
+template<class T>
+std::vector<double> BasicEmpiricalDistribution<T>::calculateDistributionFunction(const std::vector<double>& x) const {
+	sortSelection();
+	return SelectionAlgorithms::calculateDistributionFunction(selection.data(), n, x);
 }
 
-void EmpiricalDistribution::save(std::ofstream& file) {
+template<class T>
+double BasicEmpiricalDistribution<T>::calculateQuantile(double p) const {
+	sortSelection();
+	return SelectionAlgorithms::calculateQuantile(selection.data(), n, p);
+}
+
+template<class T>
+std::vector<double> BasicEmpiricalDistribution<T>::calculateQuantile(const std::vector<double>& p) const {
+	sortSelection();
+	return SelectionAlgorithms::calculateQuantile(selection.data(), n, p);
+}
+
+template<class T>
+void BasicEmpiricalDistribution<T>::save(std::ofstream& file) {
+	sortSelection();
 	file << n << "\n";
 	for (int i = 0; i < n; i++) {
 		file << selection[i] << "\n";
@@ -265,10 +329,12 @@ void EmpiricalDistribution::save(std::ofstream& file) {
 	file << k << "\n";
 }
 
-void EmpiricalDistribution::load(std::ifstream& file) {
+template<class T>
+void BasicEmpiricalDistribution<T>::load(std::ifstream& file) {
 	selection.clear();
 	boundaries.clear();
 	frequencies.clear();
+	histogramCache.clear();
 	if (!file.is_open()) {
 		throw 0;
 	}
@@ -281,28 +347,36 @@ void EmpiricalDistribution::load(std::ifstream& file) {
 	for (int i = 0; i < n; i++) {
 		double temp;
 		file >> temp;
-		selection.push_back(temp);
+		selection.push_back((T)temp);
 	}
+	isSorted = false;
+	version = getNextVersion();
+	findExtremes();
 	file >> _k;
 	if (_k <= 1) {
 		_k = calculateK();
 	}
 	k = _k;
-	boundaries = divideSelectionIntoIntervals();
-	frequencies = calculateFrequency();
+	isHistogramBuilt = false;
 }
 
-EmpiricalDistribution::~EmpiricalDistribution() {
+template<class T>
+BasicEmpiricalDistribution<T>::~BasicEmpiricalDistribution() {
 	selection.clear();
 	boundaries.clear();
 	frequencies.clear();
+	histogramCache.clear();
 }
 
-void EmpiricalDistribution::saveDataGraph(const std::vector<double> selection, std::ofstream& file) const {
+template<class T>
+void BasicEmpiricalDistribution<T>::saveDataGraph(const std::vector<double> selection, std::ofstream& file) const {
 	if (!file.is_open()) {
 		throw 0;
 	}
 	for (int i = 0; i < selection.size(); i++) {
 		file << selection[i] << " " << calculateDensity(selection[i]) << "\n";
 	}
-}
\ No newline at end of file
+}
+
+template class BasicEmpiricalDistribution<double>;
+template class BasicEmpiricalDistribution<float>;
@@ -2,25 +2,39 @@
 #define __EMPIRICAL_DIST_H
 
 #include "distribution.h"
+#include "selection_algorithms.h"
+#include <atomic>
+#include <mutex>
 
-class EmpiricalDistribution : public IDistribution, public IPersistent {
+/*  , T -    .
+   ,         double */
+template<class T>
+class BasicEmpiricalDistribution : public IDistribution, public IPersistent {
 public:
-	EmpiricalDistribution(int _n, const IDistribution& _d, int _k = 1);
-	EmpiricalDistribution(std::ifstream& file);
-	EmpiricalDistribution& operator=(const EmpiricalDistribution& d);
-	EmpiricalDistribution(const EmpiricalDistribution& d);
+	BasicEmpiricalDistribution(int _n, const IDistribution& _d, int _k = 1);
+	BasicEmpiricalDistribution(std::ifstream& file);
+	BasicEmpiricalDistribution& operator=(const BasicEmpiricalDistribution& d);
+	BasicEmpiricalDistribution(const BasicEmpiricalDistribution& d);
 	
 	/*       */
 	int getN() const;
 	/*     k */
 	int getK() const;
 	/*     */
-	std::vector<double> getSelection() const;
+	std::vector<T> getSelection() const;
+	/*      ,     */
+	const std::vector<T>& getUnsortedSelection() const;
 	/*      */
 	std::vector<double> getFrequencies() const;
+	/*      */
+	std::vector<double> getBoundaries() const;
 	/*     k */
 
 	void setK(int _k);
+	/*       */
+	uint64_t getVersion() const override;
+	/*     _n     */
+	void regenerate(int _n, const IDistribution& _d, int _k = 1);
 
 	/*   ,    */
 	double getRandomVariable() const override;
@@ -34,6 +48,17 @@ public:
 	double calculateCoeffAsymmetry() const override;
 	/*       */
 	double calculateCoeffKurtosis() const override;
+	/*          */
+	Moments calculateMoments() const override;
+
+	/*       x */
+	double calculateDistributionFunction(double x) const;
+	/*        */
+	std::vector<double> calculateDistributionFunction(const std::vector<double>& x) const;
+	/*     p */
+	double calculateQuantile(double p) const;
+	/*       */
+	std::vector<double> calculateQuantile(const std::vector<double>& p) const;
 
 	/*         */
 	void save(std::ofstream& file) override;
@@ -41,32 +66,48 @@ public:
 	void load(std::ifstream& file) override;
 	/*             */
 	void saveDataGraph(const std::vector<double> selection, std::ofstream& file) const override;
-	~EmpiricalDistribution();
+	~BasicEmpiricalDistribution();
 
 private:
 	int n;
 	int k;
-	std::vector<double> selection;
-	std::vector<double> boundaries;
-	std::vector<double> frequencies;
+	uint64_t version;
+	mutable std::vector<T> selection;
+	mutable std::atomic<bool> isSorted;
+	double minimum;
+	double maximum;
+	mutable std::vector<double> boundaries;
+	mutable std::vector<double> frequencies;
+	mutable std::atomic<bool> isHistogramBuilt;
+	/*       k */
+	struct Histogram {
+		int k;
+		std::vector<double> boundaries;
+		std::vector<double> frequencies;
+	};
+	static const int histogramCacheSize = 8;
+	mutable std::vector<Histogram> histogramCache;
+	/*            */
+	mutable std::mutex mutex;
 	/*  k    */
 	int calculateK() const;
 	/*     */
-	std::vector<double> generateSelection(const IDistribution& d);
+	std::vector<T> generateSelection(const IDistribution& d);
+	/*       */
+	void findExtremes();
+	/*     ,   */
+	void sortSelection() const;
 	/*     */
 	double calculateDelta() const;
 	/*     */
 	std::vector<double> divideSelectionIntoIntervals() const;
-	/*       ,   Xni */
-	int leftsideBirnarySearch(double min) const;
-	/*       ,   Xni */
-	int rightsideBirnarySearch(double max) const;
 	/*      */
 	std::vector<double> calculateFrequency() const;
-	/*  ,   x */
-	int getIndexInterval(double x) const;
-	/*    */
-	double calculateCumulProb(int i) const;
+	/*           */
+	void buildHistogram() const;
 };
 
+typedef BasicEmpiricalDistribution<double> EmpiricalDistribution;
+typedef BasicEmpiricalDistribution<float> FloatEmpiricalDistribution;
+
 #endif // !__EMPIRICAL_DIST_H
\ No newline at end of file
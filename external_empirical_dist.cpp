@@ -0,0 +1,358 @@
+﻿#include "external_empirical_dist.h"
+#include <cstdio>
+#include <functional>
+#include <queue>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ExternalEmpiricalDistribution::ExternalEmpiricalDistribution(std::ifstream& file, const std::string& _directory, long long _chunkSize) :
+	n(0), k(0), version(0), directory(_directory), chunkSize(_chunkSize > 1 ? _chunkSize : throw 1), selection(nullptr) {
+#ifdef _WIN32
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	fileDescriptor = -1;
+#endif
+	path = createTemporaryFile();
+	try {
+		load(file);
+	}
+	catch (...) {
+		unmapSelection();
+		std::remove(path.c_str());
+		throw;
+	}
+}
+
+std::string ExternalEmpiricalDistribution::createTemporaryFile() const {
+#ifdef _WIN32
+	char name[MAX_PATH];
+	if (GetTempFileNameA(directory.c_str(), "emp", 0, name) == 0) {
+		throw 0;
+	}
+	return name;
+#else
+	std::string name = directory + "/empirical_XXXXXX";
+	int descriptor = mkstemp(&name[0]);
+	if (descriptor < 0) {
+		throw 0;
+	}
+	close(descriptor);
+	return name;
+#endif
+}
+
+int ExternalEmpiricalDistribution::calculateK() const {
+	return (int)ceil(log2(n) + 1);
+}
+
+void ExternalEmpiricalDistribution::sortExternally(std::ifstream& file) {
+	/* Порции удаляются при выходе из функции, в том числе по исключению */
+	struct RunFiles {
+		std::vector<std::string> names;
+		~RunFiles() {
+			for (auto& name : names) {
+				std::remove(name.c_str());
+			}
+		}
+	} runs;
+	std::vector<double> chunk;
+	for (long long read = 0; read < n; read += chunk.size()) {
+		long long size = std::min(chunkSize, n - read);
+		chunk.resize(size);
+		for (long long i = 0; i < size; i++) {
+			file >> chunk[i];
+		}
+		if (!file) {
+			throw 0;
+		}
+		SelectionAlgorithms::radixSort(chunk);
+		runs.names.push_back(createTemporaryFile());
+		std::ofstream out(runs.names.back(), std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			throw 0;
+		}
+		out.write((const char*)chunk.data(), size * sizeof(double));
+		out.close();
+		if (!out) {
+			throw 0;
+		}
+	}
+	chunk.clear();
+	chunk.shrink_to_fit();
+	/* Пока порций больше mergeFanIn, они сливаются группами в промежуточные файлы,
+	   а слитые порции удаляются по завершении прохода */
+	while (runs.names.size() > mergeFanIn) {
+		RunFiles merged;
+		for (size_t i = 0; i < runs.names.size(); i += mergeFanIn) {
+			std::vector<std::string> group(runs.names.begin() + i, runs.names.begin() + std::min(i + mergeFanIn, runs.names.size()));
+			merged.names.push_back(createTemporaryFile());
+			mergeRuns(group, merged.names.back());
+		}
+		runs.names.swap(merged.names);
+	}
+	mergeRuns(runs.names, path);
+}
+
+void ExternalEmpiricalDistribution::mergeRuns(const std::vector<std::string>& runs, const std::string& output) const {
+	const size_t bufferSize = 1 << 16;
+	struct Run {
+		std::ifstream file;
+		std::vector<double> buffer;
+		size_t position;
+		size_t size;
+	};
+	std::vector<Run> readers(runs.size());
+	typedef std::pair<double, size_t> Head;
+	std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+	auto refill = [&](size_t i) {
+		Run& run = readers[i];
+		run.file.read((char*)run.buffer.data(), bufferSize * sizeof(double));
+		run.size = run.file.gcount() / sizeof(double);
+		run.position = 0;
+		return run.size > 0;
+	};
+	for (size_t i = 0; i < runs.size(); i++) {
+		readers[i].file.open(runs[i], std::ios::binary);
+		if (!readers[i].file.is_open()) {
+			throw 0;
+		}
+		readers[i].buffer.resize(bufferSize);
+		if (refill(i)) {
+			heads.push({ readers[i].buffer[0], i });
+		}
+	}
+	std::ofstream out(output, std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		throw 0;
+	}
+	std::vector<double> merged;
+	merged.reserve(bufferSize);
+	while (!heads.empty()) {
+		Head head = heads.top();
+		heads.pop();
+		merged.push_back(head.first);
+		if (merged.size() == bufferSize) {
+			out.write((const char*)merged.data(), merged.size() * sizeof(double));
+			merged.clear();
+		}
+		Run& run = readers[head.second];
+		if (++run.position < run.size || refill(head.second)) {
+			heads.push({ run.buffer[run.position], head.second });
+		}
+	}
+	out.write((const char*)merged.data(), merged.size() * sizeof(double));
+	if (!out) {
+		throw 0;
+	}
+}
+
+void ExternalEmpiricalDistribution::mapSelection() {
+	size_t size = n * sizeof(double);
+#ifdef _WIN32
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE) {
+		fileHandle = nullptr;
+		throw 0;
+	}
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) {
+		throw 0;
+	}
+	selection = (const double*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, size);
+	if (selection == nullptr) {
+		throw 0;
+	}
+#else
+	fileDescriptor = open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0) {
+		throw 0;
+	}
+	void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+	if (address == MAP_FAILED) {
+		throw 0;
+	}
+	selection = (const double*)address;
+#endif
+}
+
+void ExternalEmpiricalDistribution::unmapSelection() {
+#ifdef _WIN32
+	if (selection != nullptr) {
+		UnmapViewOfFile(selection);
+	}
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+	if (fileHandle != nullptr) {
+		CloseHandle(fileHandle);
+	}
+	mappingHandle = nullptr;
+	fileHandle = nullptr;
+#else
+	if (selection != nullptr) {
+		munmap((void*)selection, n * sizeof(double));
+	}
+	if (fileDescriptor >= 0) {
+		close(fileDescriptor);
+	}
+	fileDescriptor = -1;
+#endif
+	selection = nullptr;
+}
+
+double ExternalEmpiricalDistribution::calculateDelta() const {
+	return (1.0 / k) * (selection[n - 1] - selection[0]);
+}
+
+std::vector<double> ExternalEmpiricalDistribution::divideSelectionIntoIntervals() const {
+	return SelectionAlgorithms::divideIntoIntervals(selection[0], selection[n - 1], k);
+}
+
+std::vector<double> ExternalEmpiricalDistribution::calculateFrequency() const {
+	std::vector<double> frequencies;
+	int m = boundaries.size() - 1;
+	double delta = calculateDelta();
+	long long left = 0;
+	for (int i = 0; i < m; i++) {
+		long long right = n;
+		if (i < m - 1) {
+			right = std::lower_bound(selection + left, selection + n, boundaries[i + 1]) - selection;
+		}
+		frequencies.push_back((right - left) / (n * delta));
+		left = right;
+	}
+	return frequencies;
+}
+
+uint64_t ExternalEmpiricalDistribution::getVersion() const {
+	return version;
+}
+
+long long ExternalEmpiricalDistribution::getN() const {
+	return n;
+}
+
+int ExternalEmpiricalDistribution::getK() const {
+	return k;
+}
+
+std::vector<double> ExternalEmpiricalDistribution::getFrequencies() const {
+	return frequencies;
+}
+
+std::vector<double> ExternalEmpiricalDistribution::getBoundaries() const {
+	return boundaries;
+}
+
+void ExternalEmpiricalDistribution::setK(int _k) {
+	if (_k <= 1) {
+		_k = calculateK();
+	}
+	k = _k;
+	version = getNextVersion();
+	boundaries = divideSelectionIntoIntervals();
+	frequencies = calculateFrequency();
+}
+
+double ExternalEmpiricalDistribution::getRandomVariable() const {
+	return SelectionAlgorithms::generateFromHistogram(boundaries, frequencies);
+}
+
+double ExternalEmpiricalDistribution::calculateDensity(double x) const {
+	int i = SelectionAlgorithms::getIndexInterval(boundaries, x);
+	return i < 0 ? 0 : frequencies[i];
+}
+
+double ExternalEmpiricalDistribution::calculateMathExpectation() const {
+	return SelectionAlgorithms::calculateMathExpectation(selection, n);
+}
+
+double ExternalEmpiricalDistribution::calculateVariance() const {
+	return SelectionAlgorithms::calculateVariance(selection, n);
+}
+
+double ExternalEmpiricalDistribution::calculateCoeffAsymmetry() const {
+	return SelectionAlgorithms::calculateCoeffAsymmetry(selection, n);
+}
+
+double ExternalEmpiricalDistribution::calculateCoeffKurtosis() const {
+	return SelectionAlgorithms::calculateCoeffKurtosis(selection, n);
+}
+
+Moments ExternalEmpiricalDistribution::calculateMoments() const {
+	return SelectionAlgorithms::calculateMoments(selection, n);
+}
+
+double ExternalEmpiricalDistribution::calculateDistributionFunction(double x) const {
+	return SelectionAlgorithms::calculateDistributionFunction(selection, n, x);
+}
+
+std::vector<double> ExternalEmpiricalDistribution::calculateDistributionFunction(const std::vector<double>& x) const {
+	return SelectionAlgorithms::calculateDistributionFunction(selection, n, x);
+}
+
+double ExternalEmpiricalDistribution::calculateQuantile(double p) const {
+	return SelectionAlgorithms::calculateQuantile(selection, n, p);
+}
+
+std::vector<double> ExternalEmpiricalDistribution::calculateQuantile(const std::vector<double>& p) const {
+	return SelectionAlgorithms::calculateQuantile(selection, n, p);
+}
+
+void ExternalEmpiricalDistribution::save(std::ofstream& file) {
+	file << n << "\n";
+	for (long long i = 0; i < n; i++) {
+		file << selection[i] << "\n";
+	}
+	file << k << "\n";
+}
+
+void ExternalEmpiricalDistribution::load(std::ifstream& file) {
+	if (!file.is_open()) {
+		throw 0;
+	}
+	unmapSelection();
+	boundaries.clear();
+	frequencies.clear();
+	long long _n;
+	int _k;
+	file >> _n;
+	if (_n <= 1) {
+		throw 1;
+	}
+	n = _n;
+	sortExternally(file);
+	mapSelection();
+	file >> _k;
+	if (_k <= 1) {
+		_k = calculateK();
+	}
+	k = _k;
+	version = getNextVersion();
+	boundaries = divideSelectionIntoIntervals();
+	frequencies = calculateFrequency();
+}
+
+void ExternalEmpiricalDistribution::saveDataGraph(const std::vector<double> selection, std::ofstream& file) const {
+	if (!file.is_open()) {
+		throw 0;
+	}
+	for (int i = 0; i < selection.size(); i++) {
+		file << selection[i] << " " << calculateDensity(selection[i]) << "\n";
+	}
+}
+
+ExternalEmpiricalDistribution::~ExternalEmpiricalDistribution() {
+	unmapSelection();
+	std::remove(path.c_str());
+}
@@ -0,0 +1,104 @@
+﻿#ifndef __EXTERNAL_EMPIRICAL_DIST_H
+#define __EXTERNAL_EMPIRICAL_DIST_H
+
+#include "empirical_dist.h"
+#include <string>
+
+/* Эмпирическое распределение для выборок, не помещающихся в оперативную память.
+   Выборка сортируется во внешней памяти в уникальных временных файлах каталога directory многопроходным слиянием отсортированных порций и затем
+   отображается в память из файла, результаты совпадают с EmpiricalDistribution
+   с отсортированной выборкой */
+class ExternalEmpiricalDistribution : public IDistribution, public IPersistent {
+public:
+	ExternalEmpiricalDistribution(std::ifstream& file, const std::string& _directory = ".", long long _chunkSize = 1 << 24);
+	ExternalEmpiricalDistribution(const ExternalEmpiricalDistribution& d) = delete;
+	ExternalEmpiricalDistribution& operator=(const ExternalEmpiricalDistribution& d) = delete;
+
+	/* Функция для получения параметра размера выборки */
+	long long getN() const;
+	/* Функция для получения параметра k */
+	int getK() const;
+	/* Функция для получения массива частностей */
+	std::vector<double> getFrequencies() const;
+	/* Функция для получения границ интервалов */
+	std::vector<double> getBoundaries() const;
+	/* Функция для установки параметра k */
+	void setK(int _k);
+	/* Функция для получения номера изменения выборки */
+	uint64_t getVersion() const override;
+
+	/* Генерация случайной величины, имеющей эмпирическое распределение */
+	double getRandomVariable() const override;
+	/* Вычисление функции плотности для эмпирического распределения */
+	double calculateDensity(double x) const override;
+	/* Вычисление математического ожидания для эмпирического распределения */
+	double calculateMathExpectation() const override;
+	/* Вычисление дисперсии для эмпирического распределения */
+	double calculateVariance() const override;
+	/* Вычисление коэффицинта асимметрии для эмпирического распределения */
+	double calculateCoeffAsymmetry() const override;
+	/* Вычисление коэффицинта эксцесса для эмпирического распределения */
+	double calculateCoeffKurtosis() const override;
+	/* Вычисление всех моментных характеристик за два прохода по выборке */
+	Moments calculateMoments() const override;
+
+	/* Вычисление эмпирической функции распределения в точке x */
+	double calculateDistributionFunction(double x) const;
+	/* Вычисление эмпирической функции распределения для набора точек */
+	std::vector<double> calculateDistributionFunction(const std::vector<double>& x) const;
+	/* Вычисление выборочной квантили уровня p */
+	double calculateQuantile(double p) const;
+	/* Вычисление выборочных квантилей для набора уровней */
+	std::vector<double> calculateQuantile(const std::vector<double>& p) const;
+
+	/* Функция для сохранения выборки в файл в формате эмпирического распределения */
+	void save(std::ofstream& file) override;
+	/* Функция для загрузки выборки из файла с повторной внешней сортировкой */
+	void load(std::ifstream& file) override;
+	/* Функция для сохранения данных в файл для построения графика плостности эмпирического распределения */
+	void saveDataGraph(const std::vector<double> selection, std::ofstream& file) const override;
+	~ExternalEmpiricalDistribution();
+
+private:
+	long long n;
+	int k;
+	uint64_t version;
+	/* Каталог для временных файлов */
+	std::string directory;
+	/* Путь к отсортированному временному файлу, принадлежащему объекту */
+	std::string path;
+	/* Число элементов, сортируемых в оперативной памяти за один раз */
+	long long chunkSize;
+	/* Наибольшее число порций, сливаемых за один проход */
+	static const int mergeFanIn = 64;
+	/* Отсортированная выборка, отображенная в память */
+	const double* selection;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+	std::vector<double> boundaries;
+	std::vector<double> frequencies;
+	/* Вычисление k по формуле Стерджесса */
+	int calculateK() const;
+	/* Создание нового временного файла с уникальным именем в каталоге directory */
+	std::string createTemporaryFile() const;
+	/* Чтение выборки из файла, сортировка порций и их слияние в файл path */
+	void sortExternally(std::ifstream& file);
+	/* Слияние не более mergeFanIn отсортированных порций в файл output */
+	void mergeRuns(const std::vector<std::string>& runs, const std::string& output) const;
+	/* Отображение отсортированного файла в память */
+	void mapSelection();
+	/* Освобождение отображения */
+	void unmapSelection();
+	/* Вычисление длины для интервала */
+	double calculateDelta() const;
+	/* Разделение выборки на интервалы */
+	std::vector<double> divideSelectionIntoIntervals() const;
+	/* Функция для построения массива частотностей по позициям границ в отсортированной выборке */
+	std::vector<double> calculateFrequency() const;
+};
+
+#endif // !__EXTERNAL_EMPIRICAL_DIST_H
@@ -1,13 +1,14 @@
 #include "johnson_dist.h"
 
 JohnsonDistribution::JohnsonDistribution() :
-	form(1.0), shift(0.0), scale(1.0) {}
+	form(1.0), shift(0.0), scale(1.0), version(getNextVersion()) {}
 
 JohnsonDistribution::JohnsonDistribution(double _form, double _shift, double _scale) :
-	form(_form > 0 ? _form : throw 1), shift(_shift), scale(_scale > 0 ? _scale : throw 1) {}
+	form(_form > 0 ? _form : throw 1), shift(_shift), scale(_scale > 0 ? _scale : throw 1), version(getNextVersion()) {}
 
 
-JohnsonDistribution::JohnsonDistribution(std::ifstream& file) {
+JohnsonDistribution::JohnsonDistribution(std::ifstream& file) :
+	version(getNextVersion()) {
 	double _form, _shift, _scale;
 	file.open("johnson.txt");
 	if (!file.is_open()) {
@@ -23,10 +24,12 @@ void JohnsonDistribution::setForm(double _form) {
 		throw 1;
 	}
 	form = _form;
+	version = getNextVersion();
 }
 
 void JohnsonDistribution::setShift(double _shift) {
 	shift = _shift;
+	version = getNextVersion();
 }
 
 void JohnsonDistribution::setScale(double _scale) {
@@ -34,6 +37,7 @@ void JohnsonDistribution::setScale(double _scale) {
 		throw 1;
 	}
 	scale = _scale;
+	version = getNextVersion();
 }
 
 double JohnsonDistribution::getForm() const {
@@ -48,13 +52,17 @@ double JohnsonDistribution::getScale() const {
 	return scale;
 }
 
+uint64_t JohnsonDistribution::getVersion() const {
+	return version;
+}
+
 bool JohnsonDistribution::isStandartDistribution() const {
 	return shift == 0 && scale == 1;
 }
 
 double JohnsonDistribution::getUniformRandomVariable() const {
 	double r;
-	do r = (double)rand() / RAND_MAX; while (r == 0 || r == 1);
+	do r = getRandomUniform(); while (r == 0 || r == 1);
 	return r;
 }
 
@@ -117,6 +125,7 @@ void JohnsonDistribution::load(std::ifstream& file) {
 	form = _form;
 	shift = _shift;
 	scale = _scale;
+	version = getNextVersion();
 }
 
 void JohnsonDistribution::saveDataGraph(const std::vector<double> selection, std::ofstream& file) const {
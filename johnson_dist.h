@@ -22,6 +22,8 @@ public:
 	double getShift() const;
 	/*      */
 	double getScale() const;
+	/*       */
+	uint64_t getVersion() const override;
 
 	/*        */
 	double getRandomVariable() const override;
@@ -48,6 +50,7 @@ private:
 	double form;
 	double shift;
 	double scale;
+	uint64_t version;
 	/*      */
 	bool isStandartDistribution() const;
 	/*       (0; 1) */
@@ -1,11 +1,14 @@
 ﻿#include "distribution.h"
+#include <mutex>
 
 template<class Distribution1, class Distribution2>
 class MixtureDistribution : public IDistribution, public IPersistent {
 public:
 	MixtureDistribution(Distribution1& _d1, Distribution2& _d2, double _p) :
-		d1(_d1), d2(_d2), p(_p) {};
+		d1(_d1), d2(_d2), p(_p), version(getNextVersion()), stateVersion(0), moments(), momentsVersion(0) {};
 	MixtureDistribution(std::ifstream& file);
+	MixtureDistribution(const MixtureDistribution& d);
+	MixtureDistribution& operator=(const MixtureDistribution& d);
 
 	Distribution1& component1() { return d1; }
 	Distribution2& component2() { return d2; }
@@ -27,6 +30,10 @@ public:
 	double calculateCoeffAsymmetry() const override;
 	/* Вычисление коэффицинта эксцесса для распределения смесей */
 	double calculateCoeffKurtosis() const override;
+	/* Вычисление всех моментных характеристик смеси за один проход по компонентам */
+	Moments calculateMoments() const override;
+	/* Номер изменения смеси с учетом изменений компонент */
+	uint64_t getVersion() const override;
 
 	/* Функция для сохранения параметров рапсредления смесей в файл */
 	void save(std::ofstream& file) override;
@@ -40,12 +47,22 @@ private:
 	double p;
 	Distribution1 d1;
 	Distribution2 d2;
+	uint64_t version;
+	/* Номера изменения смеси и компонент, для которых выдан номер stateVersion */
+	mutable uint64_t seenVersion[3];
+	mutable uint64_t stateVersion;
+	/* Сохраненные моментные характеристики и номер изменения, для которого они вычислены */
+	mutable Moments moments;
+	mutable uint64_t momentsVersion;
+	/* Защита сохраненных характеристик при обращении из нескольких потоков */
+	mutable std::mutex mutex;
 	/* Генерация равномерно распределенной случайной величины на отрезке(0; 1) */
 	double getUniformRandomVariable() const;
 };
 
 template<class dist1, class dist2>
-MixtureDistribution<dist1, dist2>::MixtureDistribution(std::ifstream& file) {
+MixtureDistribution<dist1, dist2>::MixtureDistribution(std::ifstream& file) :
+	version(getNextVersion()), stateVersion(0), moments(), momentsVersion(0) {
 	double _p;
 	component1().load(file);
 	component2().load(file);
@@ -54,6 +71,35 @@ MixtureDistribution<dist1, dist2>::MixtureDistribution(std::ifstream& file) {
 		throw 1;
 	}
 	p = _p;
+	version = getNextVersion();
+}
+
+template<class dist1, class dist2>
+MixtureDistribution<dist1, dist2>::MixtureDistribution(const MixtureDistribution& d) :
+	p(d.p), d1(d.d1), d2(d.d2), version(d.version), stateVersion(0), moments(), momentsVersion(0) {}
+
+template<class dist1, class dist2>
+MixtureDistribution<dist1, dist2>& MixtureDistribution<dist1, dist2>::operator=(const MixtureDistribution& d) {
+	if (this == &d) return *this;
+	p = d.p;
+	d1 = d.d1;
+	d2 = d.d2;
+	version = d.version;
+	return *this;
+}
+
+template<class dist1, class dist2>
+uint64_t MixtureDistribution<dist1, dist2>::getVersion() const {
+	uint64_t version1 = d1.getVersion();
+	uint64_t version2 = d2.getVersion();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (stateVersion == 0 || seenVersion[0] != version || seenVersion[1] != version1 || seenVersion[2] != version2) {
+		seenVersion[0] = version;
+		seenVersion[1] = version1;
+		seenVersion[2] = version2;
+		stateVersion = getNextVersion();
+	}
+	return stateVersion;
 }
 
 template<class dist1, class dist2>
@@ -62,6 +108,7 @@ void MixtureDistribution<dist1, dist2>::setP(double _p) {
 		throw 1;
 	}
 	p = _p;
+	version = getNextVersion();
 }
 
 template<class dist1, class dist2>
@@ -72,7 +119,7 @@ double MixtureDistribution<dist1, dist2>::getP() const {
 template<class dist1, class dist2>
 double MixtureDistribution<dist1, dist2>::getUniformRandomVariable() const {
 	double r;
-	do r = (double)rand() / RAND_MAX; while (r == 0 || r == 1);
+	do r = getRandomUniform(); while (r == 0 || r == 1);
 	return r;
 }
 
@@ -90,49 +137,53 @@ double MixtureDistribution<dist1, dist2>::calculateDensity(double x) const {
 	return (1 - p) * d1.calculateDensity(x) + p * d2.calculateDensity(x);
 }
 
+template<class dist1, class dist2>
+Moments MixtureDistribution<dist1, dist2>::calculateMoments() const {
+	uint64_t currentVersion = getVersion();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (momentsVersion == currentVersion) {
+		return moments;
+	}
+	Moments moments1 = d1.calculateMoments();
+	Moments moments2 = d2.calculateMoments();
+	double M1 = moments1.mathExpectation;
+	double M2 = moments2.mathExpectation;
+	double D1 = moments1.variance;
+	double D2 = moments2.variance;
+	double gamma11 = moments1.coeffAsymmetry;
+	double gamma12 = moments2.coeffAsymmetry;
+	double gamma21 = moments1.coeffKurtosis;
+	double gamma22 = moments2.coeffKurtosis;
+	double M = (1 - p) * M1 + p * M2;
+	double D = ((1 - p) * (pow(M1, 2) + D1) + p * (pow(M2, 2) + D2)) - pow(M, 2);
+	moments.mathExpectation = M;
+	moments.variance = D;
+	moments.coeffAsymmetry = (1.0 / pow(D, 1.5)) * ((1 - p) * (pow(M1 - M, 3) + 3 * (M1 - M) * D1 + pow(D1, 1.5) * gamma11) +
+		p * (pow(M2 - M, 3) + 3 * (M2 - M) * D2 + pow(D2, 1.5) * gamma12));
+	moments.coeffKurtosis = (1.0 / pow(D, 2)) * ((1 - p) * (pow(M1 - M, 4) + 6 * pow(M1 - M, 2) * D1 + 4 * (M1 - M) * pow(D1, 1.5) * gamma11 + pow(D1, 2) * (gamma21 + 3)) +
+		p * (pow(M2 - M, 4) + 6 * pow(M2 - M, 2) * D2 + 4 * (M2 - M) * pow(D2, 1.5) * gamma12 + pow(D2, 2) * (gamma22 + 3))) - 3;
+	momentsVersion = currentVersion;
+	return moments;
+}
+
 template<class dist1, class dist2>
 double MixtureDistribution<dist1, dist2>::calculateMathExpectation() const {
-	return (1 - p) * d1.calculateMathExpectation() + p * d2.calculateMathExpectation();;
+	return calculateMoments().mathExpectation;
 }
 
 template<class dist1, class dist2>
 double MixtureDistribution<dist1, dist2>::calculateVariance() const {
-	double M = calculateMathExpectation();
-	double M1 = d1.calculateMathExpectation();
-	double M2 = d2.calculateMathExpectation();
-	double D1 = d1.calculateVariance();
-	double D2 = d2.calculateVariance();
-	return ((1 - p) * (pow(M1, 2) + D1) + p * (pow(M2, 2) + D2)) - pow(M, 2);
+	return calculateMoments().variance;
 }
 
 template<class dist1, class dist2>
 double MixtureDistribution<dist1, dist2>::calculateCoeffAsymmetry() const {
-	double M = calculateMathExpectation();
-	double M1 = d1.calculateMathExpectation();
-	double M2 = d2.calculateMathExpectation();
-	double D = calculateVariance();
-	double D1 = d1.calculateVariance();
-	double D2 = d2.calculateVariance();
-	double gamma11 = d1.calculateCoeffAsymmetry();
-	double gamma12 = d2.calculateCoeffAsymmetry();
-	return (1.0 / pow(D, 1.5)) * ((1 - p) * (pow(M1 - M, 3) + 3 * (M1 - M) * D1 + pow(D1, 1.5) * gamma11) +
-		p * (pow(M2 - M, 3) + 3 * (M2 - M) * D2 + pow(D2, 1.5) * gamma12));
+	return calculateMoments().coeffAsymmetry;
 }
 
 template<class dist1, class dist2>
 double MixtureDistribution<dist1, dist2>::calculateCoeffKurtosis() const {
-	double M = calculateMathExpectation();
-	double M1 = d1.calculateMathExpectation();
-	double M2 = d2.calculateMathExpectation();
-	double D = calculateVariance();
-	double D1 = d1.calculateVariance();
-	double D2 = d2.calculateVariance();
-	double gamma11 = d1.calculateCoeffAsymmetry();
-	double gamma12 = d2.calculateCoeffAsymmetry();
-	double gamma21 = d1.calculateCoeffKurtosis();
-	double gamma22 = d2.calculateCoeffKurtosis();
-	return (1.0 / pow(D, 2)) * ((1 - p) * (pow(M1 - M, 4) + 6 * pow(M1 - M, 2) * D1 + 4 * (M1 - M) * pow(D1, 1.5) * gamma11 + pow(D1, 2) * (gamma21 + 3)) +
-		p * (pow(M2 - M, 4) + 6 * pow(M2 - M, 2) * D2 + 4 * (M2 - M) * pow(D2, 1.5) * gamma12 + pow(D2, 2) * (gamma22 + 3))) - 3;
+	return calculateMoments().coeffKurtosis;
 }
 
 template<class dist1, class dist2>
@@ -152,6 +203,7 @@ void MixtureDistribution<dist1, dist2>::load(std::ifstream& file) {
 		throw 1;
 	}
 	p = _p;
+	version = getNextVersion();
 }
 
 template<class dist1, class dist2>
@@ -0,0 +1,143 @@
+﻿#include "parameter_sweep.h"
+#include "mixture_dist.cpp"
+
+ParameterSweep::ParameterSweep(ThreadPool& _pool, const JohnsonDistribution& _second, uint64_t _seed) :
+	pool(_pool), second(_second), seed(_seed), workspaces(_pool.getThreads()) {}
+
+void ParameterSweep::addCell(const SweepCell& cell) {
+	if (cell.form <= 0 || cell.scale <= 0 || cell.n <= 1 || cell.p < 0 || cell.p > 1) {
+		throw 1;
+	}
+	cells.push_back(cell);
+}
+
+void ParameterSweep::addGrid(const std::vector<double>& forms, const std::vector<double>& shifts, const std::vector<double>& scales,
+	const std::vector<int>& ns, const std::vector<int>& ks, const std::vector<double>& ps) {
+	for (auto& form : forms) {
+		for (auto& shift : shifts) {
+			for (auto& scale : scales) {
+				for (auto& n : ns) {
+					for (auto& k : ks) {
+						for (auto& p : ps) {
+							addCell({ form, shift, scale, n, k, p });
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+int ParameterSweep::getCellsCount() const {
+	return cells.size();
+}
+
+uint64_t ParameterSweep::calculateCellSeed(int cell) const {
+	return mixRandomSeed(seed, cell);
+}
+
+SweepResult ParameterSweep::calculateCell(const SweepCell& cell, int worker) {
+	JohnsonDistribution first(cell.form, cell.shift, cell.scale);
+	JohnsonDistribution other = second;
+	MixtureDistribution<JohnsonDistribution, JohnsonDistribution> d(first, other, cell.p);
+	if (!workspaces[worker]) {
+		workspaces[worker].reset(new EmpiricalDistribution(cell.n, d, cell.k));
+	}
+	else {
+		workspaces[worker]->regenerate(cell.n, d, cell.k);
+	}
+	EmpiricalDistribution& ed = *workspaces[worker];
+
+	SweepResult result;
+	result.mathExpectation = d.calculateMathExpectation();
+	result.variance = d.calculateVariance();
+	result.coeffAsymmetry = d.calculateCoeffAsymmetry();
+	result.coeffKurtosis = d.calculateCoeffKurtosis();
+	result.empiricalMathExpectation = ed.calculateMathExpectation();
+	result.empiricalVariance = ed.calculateVariance();
+	result.empiricalCoeffAsymmetry = ed.calculateCoeffAsymmetry();
+	result.empiricalCoeffKurtosis = ed.calculateCoeffKurtosis();
+	std::vector<double> boundaries = ed.getBoundaries();
+	std::vector<double> frequencies = ed.getFrequencies();
+	result.densityError = 0;
+	for (int i = 0; i < frequencies.size(); i++) {
+		double width = boundaries[i + 1] - boundaries[i];
+		double middle = boundaries[i] + width / 2;
+		result.densityError += fabs(frequencies[i] - d.calculateDensity(middle)) * width;
+	}
+	return result;
+}
+
+void ParameterSweep::writeRow(std::ofstream& file, Format format, const SweepCell& cell, const SweepResult& result) const {
+	if (format == BINARY) {
+		file.write((const char*)&cell.form, sizeof(double));
+		file.write((const char*)&cell.shift, sizeof(double));
+		file.write((const char*)&cell.scale, sizeof(double));
+		file.write((const char*)&cell.p, sizeof(double));
+		int32_t n = cell.n;
+		int32_t k = cell.k;
+		file.write((const char*)&n, sizeof(int32_t));
+		file.write((const char*)&k, sizeof(int32_t));
+		file.write((const char*)&result, sizeof(SweepResult));
+		return;
+	}
+	file << cell.form << "," << cell.shift << "," << cell.scale << "," << cell.n << "," << cell.k << "," << cell.p << ","
+		<< result.mathExpectation << "," << result.variance << "," << result.coeffAsymmetry << "," << result.coeffKurtosis << ","
+		<< result.empiricalMathExpectation << "," << result.empiricalVariance << "," << result.empiricalCoeffAsymmetry << ","
+		<< result.empiricalCoeffKurtosis << "," << result.densityError << "\n";
+}
+
+void ParameterSweep::run(std::ofstream& file, Format format) {
+	if (!file.is_open()) {
+		throw 0;
+	}
+	int count = cells.size();
+	results.resize(count);
+	std::unique_ptr<std::atomic<int>[]> states(new std::atomic<int>[count]);
+	for (int i = 0; i < count; i++) {
+		states[i] = 0;
+	}
+	std::mutex mutex;
+	std::condition_variable ready;
+
+	for (int i = 0; i < count; i++) {
+		pool.submit([this, i, &states, &mutex, &ready](int worker) {
+			int state = 1;
+			std::exception_ptr error;
+			try {
+				setRandomSeed(calculateCellSeed(i));
+				results[i] = calculateCell(cells[i], worker);
+			}
+			catch (...) {
+				state = 2;
+				error = std::current_exception();
+			}
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				states[i] = state;
+			}
+			ready.notify_all();
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		});
+	}
+
+	if (format == BINARY) {
+		int64_t rows = count;
+		file.write((const char*)&rows, sizeof(int64_t));
+	}
+	else {
+		file << "form,shift,scale,n,k,p,M,D,gamma1,gamma2,M*,D*,gamma1*,gamma2*,density_error\n";
+	}
+	for (int i = 0; i < count; i++) {
+		std::unique_lock<std::mutex> lock(mutex);
+		ready.wait(lock, [&states, i]() { return states[i] != 0; });
+		lock.unlock();
+		if (states[i] == 2) {
+			break;
+		}
+		writeRow(file, format, cells[i], results[i]);
+	}
+	pool.wait();
+}
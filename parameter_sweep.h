@@ -0,0 +1,68 @@
+﻿#ifndef __PARAMETER_SWEEP_H
+#define __PARAMETER_SWEEP_H
+
+#include "johnson_dist.h"
+#include "empirical_dist.h"
+#include "thread_pool.h"
+
+/* Ячейка сетки параметров: первая компонента смеси, объем выборки, k и параметр смеси */
+struct SweepCell {
+	double form;
+	double shift;
+	double scale;
+	int n;
+	int k;
+	double p;
+};
+
+/* Теоретические и эмпирические характеристики для ячейки сетки */
+struct SweepResult {
+	double mathExpectation;
+	double variance;
+	double coeffAsymmetry;
+	double coeffKurtosis;
+	double empiricalMathExpectation;
+	double empiricalVariance;
+	double empiricalCoeffAsymmetry;
+	double empiricalCoeffKurtosis;
+	/* Интегральная ошибка гистограммы относительно теоретической плотности */
+	double densityError;
+};
+
+/* Параллельный перебор сетки параметров для исследования сходимости эмпирических оценок.
+   Ячейка - смесь распределения Джонсона с параметрами ячейки и фиксированной второй компоненты
+   с весом p, при p = 0 - само распределение Джонсона */
+class ParameterSweep {
+public:
+	enum Format { CSV, BINARY };
+
+	ParameterSweep(ThreadPool& _pool, const JohnsonDistribution& _second, uint64_t _seed = 1);
+
+	/* Добавление одной ячейки */
+	void addCell(const SweepCell& cell);
+	/* Добавление декартова произведения значений параметров */
+	void addGrid(const std::vector<double>& forms, const std::vector<double>& shifts, const std::vector<double>& scales,
+		const std::vector<int>& ns, const std::vector<int>& ks, const std::vector<double>& ps);
+	/* Функция для получения числа ячеек */
+	int getCellsCount() const;
+
+	/* Расчет всех ячеек с записью результатов в файл в порядке ячеек по мере готовности */
+	void run(std::ofstream& file, Format format = CSV);
+
+private:
+	ThreadPool& pool;
+	JohnsonDistribution second;
+	uint64_t seed;
+	std::vector<SweepCell> cells;
+	std::vector<SweepResult> results;
+	/* Эмпирические распределения, переиспользуемые потоками пула между ячейками */
+	std::vector<std::unique_ptr<EmpiricalDistribution>> workspaces;
+	/* Зерно генератора для ячейки, не зависящее от порядка расчета */
+	uint64_t calculateCellSeed(int cell) const;
+	/* Расчет одной ячейки в потоке worker */
+	SweepResult calculateCell(const SweepCell& cell, int worker);
+	/* Запись строки результатов */
+	void writeRow(std::ofstream& file, Format format, const SweepCell& cell, const SweepResult& result) const;
+};
+
+#endif // !__PARAMETER_SWEEP_H
@@ -0,0 +1,45 @@
+﻿#include "selection_algorithms.h"
+
+std::vector<double> SelectionAlgorithms::divideIntoIntervals(double minimum, double maximum, int k) {
+	std::vector<double> boundaries;
+	double next = minimum;
+	double delta = (1.0 / k) * (maximum - minimum);
+	boundaries.push_back(next);
+	while (next < maximum) {
+		boundaries.push_back(next + delta);
+		next += delta;
+	}
+	return boundaries;
+}
+
+int SelectionAlgorithms::getIndexInterval(const std::vector<double>& boundaries, double x) {
+	for (int i = 0; i < (int)boundaries.size() - 1; i++) {
+		if (x >= boundaries[i] && x < boundaries[i + 1]) {
+			return i;
+		}
+	}
+	if (boundaries.size() > 1 && x >= boundaries[boundaries.size() - 2] && x <= boundaries[boundaries.size() - 1]) {
+		return boundaries.size() - 2;
+	}
+	return -1;
+}
+
+double SelectionAlgorithms::generateFromHistogram(const std::vector<double>& boundaries, const std::vector<double>& frequencies) {
+	int m = frequencies.size();
+	if (m == 0) {
+		return boundaries[0];
+	}
+	double topBound = 0;
+	for (auto& f : frequencies) {
+		topBound += f;
+	}
+	double r;
+	do r = getRandomUniform() * topBound;
+	while (r == 0);
+	int i = 0;
+	double q = frequencies[0];
+	while (i < m - 1 && r >= q) {
+		q += frequencies[++i];
+	}
+	return boundaries[i] + getRandomUniform() * (boundaries[i + 1] - boundaries[i]);
+}
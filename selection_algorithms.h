@@ -0,0 +1,225 @@
+﻿#ifndef __SELECTION_ALGORITHMS_H
+#define __SELECTION_ALGORITHMS_H
+
+#include "distribution.h"
+
+/* Общие алгоритмы над выборкой, заданной указателем на элементы и их числом.
+   Используются эмпирическим распределением в оперативной памяти и во внешней памяти */
+class SelectionAlgorithms {
+public:
+	/* Поразрядная сортировка массива вещественных чисел */
+	template<class T>
+	static void radixSort(std::vector<T>& values);
+	/* Разделение отрезка [minimum; maximum] на k интервалов */
+	static std::vector<double> divideIntoIntervals(double minimum, double maximum, int k);
+	/* Поиск интервала, которому принадлежит x, -1 при x вне гистограммы */
+	static int getIndexInterval(const std::vector<double>& boundaries, double x);
+	/* Генерация случайной величины с распределением, заданным гистограммой */
+	static double generateFromHistogram(const std::vector<double>& boundaries, const std::vector<double>& frequencies);
+
+	/* Вычисление математического ожидания по выборке */
+	template<class T>
+	static double calculateMathExpectation(const T* selection, long long n);
+	/* Вычисление дисперсии по выборке */
+	template<class T>
+	static double calculateVariance(const T* selection, long long n);
+	/* Вычисление коэффицинта асимметрии по выборке */
+	template<class T>
+	static double calculateCoeffAsymmetry(const T* selection, long long n);
+	/* Вычисление коэффицинта эксцесса по выборке */
+	template<class T>
+	static double calculateCoeffKurtosis(const T* selection, long long n);
+	/* Вычисление всех моментных характеристик за два прохода по выборке */
+	template<class T>
+	static Moments calculateMoments(const T* selection, long long n);
+
+	/* Вычисление эмпирической функции распределения в точке x по отсортированной выборке */
+	template<class T>
+	static double calculateDistributionFunction(const T* selection, long long n, double x);
+	/* Вычисление эмпирической функции распределения для набора точек по отсортированной выборке */
+	template<class T>
+	static std::vector<double> calculateDistributionFunction(const T* selection, long long n, const std::vector<double>& x);
+	/* Вычисление выборочной квантили уровня p по отсортированной выборке */
+	template<class T>
+	static double calculateQuantile(const T* selection, long long n, double p);
+	/* Вычисление выборочных квантилей для набора уровней по отсортированной выборке */
+	template<class T>
+	static std::vector<double> calculateQuantile(const T* selection, long long n, const std::vector<double>& p);
+};
+
+template<class T>
+void SelectionAlgorithms::radixSort(std::vector<T>& values) {
+	if (values.size() < 256) {
+		sort(values.begin(), values.end());
+		return;
+	}
+	typedef typename std::conditional<sizeof(T) == sizeof(uint64_t), uint64_t, uint32_t>::type Key;
+	const int digits = sizeof(Key);
+	const Key signBit = (Key)1 << (8 * sizeof(Key) - 1);
+	/* Ключи хранятся на месте элементов values, дополнительно нужен только один буфер */
+	std::vector<size_t> counts(digits * 256, 0);
+	for (size_t i = 0; i < values.size(); i++) {
+		Key key;
+		memcpy(&key, &values[i], sizeof(key));
+		key ^= (key & signBit) ? (Key)~(Key)0 : signBit;
+		memcpy(&values[i], &key, sizeof(key));
+		for (int digit = 0; digit < digits; digit++) {
+			counts[digit * 256 + ((key >> (8 * digit)) & 0xFF)]++;
+		}
+	}
+	std::vector<Key> buffer(values.size());
+	bool inBuffer = false;
+	for (int digit = 0; digit < digits; digit++) {
+		size_t* count = &counts[digit * 256];
+		int shift = 8 * digit;
+		Key first;
+		memcpy(&first, &values[0], sizeof(first));
+		if (count[(first >> shift) & 0xFF] == values.size()) {
+			continue;
+		}
+		size_t offset = 0;
+		for (int i = 0; i < 256; i++) {
+			size_t temp = count[i];
+			count[i] = offset;
+			offset += temp;
+		}
+		if (!inBuffer) {
+			for (size_t i = 0; i < values.size(); i++) {
+				Key key;
+				memcpy(&key, &values[i], sizeof(key));
+				buffer[count[(key >> shift) & 0xFF]++] = key;
+			}
+		}
+		else {
+			for (auto& key : buffer) {
+				memcpy(&values[count[(key >> shift) & 0xFF]++], &key, sizeof(key));
+			}
+		}
+		inBuffer = !inBuffer;
+	}
+	for (size_t i = 0; i < values.size(); i++) {
+		Key key;
+		if (inBuffer) {
+			key = buffer[i];
+		}
+		else {
+			memcpy(&key, &values[i], sizeof(key));
+		}
+		key ^= (key & signBit) ? signBit : (Key)~(Key)0;
+		memcpy(&values[i], &key, sizeof(key));
+	}
+}
+
+template<class T>
+double SelectionAlgorithms::calculateMathExpectation(const T* selection, long long n) {
+	double sum = 0;
+	for (long long i = 0; i < n; i++) {
+		sum += selection[i];
+	}
+	return sum / n;
+}
+
+template<class T>
+double SelectionAlgorithms::calculateVariance(const T* selection, long long n) {
+	double M = calculateMathExpectation(selection, n);
+	double sum = 0;
+	for (long long i = 0; i < n; i++) {
+		sum += pow(selection[i] - M, 2);
+	}
+	return sum / n;
+}
+
+template<class T>
+double SelectionAlgorithms::calculateCoeffAsymmetry(const T* selection, long long n) {
+	double M = calculateMathExpectation(selection, n);
+	double D = calculateVariance(selection, n);
+	double sum = 0;
+	for (long long i = 0; i < n; i++) {
+		sum += pow(selection[i] - M, 3);
+	}
+	return sum / (n * pow(D, 1.5));
+}
+
+template<class T>
+double SelectionAlgorithms::calculateCoeffKurtosis(const T* selection, long long n) {
+	double M = calculateMathExpectation(selection, n);
+	double D = calculateVariance(selection, n);
+	double sum = 0;
+	for (long long i = 0; i < n; i++) {
+		sum += pow(selection[i] - M, 4);
+	}
+	return sum / (n * pow(D, 2)) - 3;
+}
+
+template<class T>
+Moments SelectionAlgorithms::calculateMoments(const T* selection, long long n) {
+	double M = calculateMathExpectation(selection, n);
+	double sum2 = 0, sum3 = 0, sum4 = 0;
+	for (long long i = 0; i < n; i++) {
+		double d = selection[i] - M;
+		double d2 = d * d;
+		sum2 += d2;
+		sum3 += d2 * d;
+		sum4 += d2 * d2;
+	}
+	double D = sum2 / n;
+	return { M, D, sum3 / (n * pow(D, 1.5)), sum4 / (n * pow(D, 2)) - 3 };
+}
+
+template<class T>
+double SelectionAlgorithms::calculateDistributionFunction(const T* selection, long long n, double x) {
+	if (std::isnan(x)) {
+		throw 1;
+	}
+	return (double)(std::upper_bound(selection, selection + n, x) - selection) / n;
+}
+
+template<class T>
+std::vector<double> SelectionAlgorithms::calculateDistributionFunction(const T* selection, long long n, const std::vector<double>& x) {
+	for (auto& value : x) {
+		if (std::isnan(value)) {
+			throw 1;
+		}
+	}
+	std::vector<double> result(x.size());
+	if (x.size() * log2(n) < n) {
+		for (int i = 0; i < x.size(); i++) {
+			result[i] = calculateDistributionFunction(selection, n, x[i]);
+		}
+		return result;
+	}
+	std::vector<int> order(x.size());
+	for (int i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	sort(order.begin(), order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+	long long count = 0;
+	for (int i = 0; i < order.size(); i++) {
+		double value = x[order[i]];
+		while (count < n && selection[count] <= value) {
+			count++;
+		}
+		result[order[i]] = (double)count / n;
+	}
+	return result;
+}
+
+template<class T>
+double SelectionAlgorithms::calculateQuantile(const T* selection, long long n, double p) {
+	if (!(p >= 0 && p <= 1)) {
+		throw 1;
+	}
+	long long i = (long long)ceil(p * n) - 1;
+	return selection[i > 0 ? i : 0];
+}
+
+template<class T>
+std::vector<double> SelectionAlgorithms::calculateQuantile(const T* selection, long long n, const std::vector<double>& p) {
+	std::vector<double> result(p.size());
+	for (int i = 0; i < p.size(); i++) {
+		result[i] = calculateQuantile(selection, n, p[i]);
+	}
+	return result;
+}
+
+#endif // !__SELECTION_ALGORITHMS_H
@@ -0,0 +1,181 @@
+﻿#include "selection_pipeline.h"
+
+BlockQueue::BlockQueue(int capacity) {
+	size_t size = 1;
+	while (size < (size_t)capacity) {
+		size <<= 1;
+	}
+	cells.reset(new Cell[size]);
+	for (size_t i = 0; i < size; i++) {
+		cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	mask = size - 1;
+	enqueuePosition.store(0, std::memory_order_relaxed);
+	dequeuePosition.store(0, std::memory_order_relaxed);
+}
+
+bool BlockQueue::push(int block) {
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell& cell = cells[position & mask];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+		if (difference == 0) {
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				cell.block = block;
+				cell.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			return false;
+		}
+		else {
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool BlockQueue::pop(int& block) {
+	size_t position = dequeuePosition.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell& cell = cells[position & mask];
+		size_t sequence = cell.sequence.load(std::memory_order_acquire);
+		intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+		if (difference == 0) {
+			if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+				block = cell.block;
+				cell.sequence.store(position + mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (difference < 0) {
+			return false;
+		}
+		else {
+			position = dequeuePosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+SelectionPipeline::SelectionPipeline(const IDistribution& _d, int _threads, int _blockSize, int _blocks, uint64_t _seed) :
+	d(_d), blockSize(_blockSize > 0 ? _blockSize : throw 1), seed(_seed) {
+	if (_threads <= 0) {
+		_threads = (int)std::thread::hardware_concurrency() - 1;
+	}
+	threads = _threads > 0 ? _threads : 1;
+	blocks = _blocks > threads ? _blocks : 2 * threads + 2;
+}
+
+void SelectionPipeline::save(long long n, std::ofstream& file, int k) {
+	if (!file.is_open()) {
+		throw 0;
+	}
+	if (n <= 1) {
+		throw 1;
+	}
+	file << n << "\n";
+	run(n, file, false);
+	file << k << "\n";
+}
+
+void SelectionPipeline::saveDataGraph(long long n, std::ofstream& file) {
+	if (!file.is_open()) {
+		throw 0;
+	}
+	run(n, file, true);
+}
+
+void SelectionPipeline::backoff(int& attempt) {
+	if (attempt < 16) {
+		std::this_thread::yield();
+	}
+	else {
+		std::this_thread::sleep_for(std::chrono::microseconds(1 << std::min(attempt - 16, 10)));
+	}
+	attempt++;
+}
+
+void SelectionPipeline::run(long long n, std::ofstream& file, bool withDensity) {
+	std::vector<Block> pool(blocks);
+	for (auto& block : pool) {
+		block.values.resize(blockSize);
+		block.text.resize((size_t)blockSize * (withDensity ? 2 * maxNumberLength + 2 : maxNumberLength + 1));
+	}
+	BlockQueue freeBlocks(blocks);
+	BlockQueue fullBlocks(blocks);
+	for (int i = 0; i < blocks; i++) {
+		freeBlocks.push(i);
+	}
+	long long total = (n + blockSize - 1) / blockSize;
+	std::atomic<long long> next(0);
+	std::atomic<bool> failed(false);
+	std::exception_ptr error;
+	std::mutex errorMutex;
+
+	std::vector<std::thread> samplers;
+	for (int t = 0; t < threads; t++) {
+		samplers.emplace_back([&, t]() {
+			try {
+				setRandomSeed(seed + t);
+				for (long long b = next++; b < total; b = next++) {
+					int index;
+					for (int attempt = 0; !freeBlocks.pop(index); ) {
+						if (failed) {
+							return;
+						}
+						backoff(attempt);
+					}
+					Block& block = pool[index];
+					int size = (int)std::min<long long>(blockSize, n - b * blockSize);
+					for (int i = 0; i < size; i++) {
+						block.values[i] = d.getRandomVariable();
+					}
+					char* position = block.text.data();
+					char* end = position + block.text.size();
+					for (int i = 0; i < size; i++) {
+						position = std::to_chars(position, end, block.values[i]).ptr;
+						if (withDensity) {
+							*position++ = ' ';
+							position = std::to_chars(position, end, d.calculateDensity(block.values[i])).ptr;
+						}
+						*position++ = '\n';
+					}
+					block.length = position - block.text.data();
+					for (int attempt = 0; !fullBlocks.push(index); ) {
+						backoff(attempt);
+					}
+				}
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(errorMutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+				failed = true;
+			}
+		});
+	}
+
+	for (long long written = 0; written < total && !failed; written++) {
+		int index;
+		for (int attempt = 0; !fullBlocks.pop(index); ) {
+			if (failed) {
+				break;
+			}
+			backoff(attempt);
+		}
+		if (failed) {
+			break;
+		}
+		Block& block = pool[index];
+		file.write(block.text.data(), block.length);
+		freeBlocks.push(index);
+	}
+	for (auto& sampler : samplers) {
+		sampler.join();
+	}
+	if (error) {
+		std::rethrow_exception(error);
+	}
+}
@@ -0,0 +1,65 @@
+﻿#ifndef __SELECTION_PIPELINE_H
+#define __SELECTION_PIPELINE_H
+
+#include "distribution.h"
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+/* Ограниченная неблокирующая очередь номеров блоков (кольцевой буфер Вьюкова) */
+class BlockQueue {
+public:
+	BlockQueue(int capacity);
+
+	/* Добавление номера блока, false при заполненной очереди */
+	bool push(int block);
+	/* Извлечение номера блока, false при пустой очереди */
+	bool pop(int& block);
+
+private:
+	struct Cell {
+		std::atomic<size_t> sequence;
+		int block;
+	};
+	std::unique_ptr<Cell[]> cells;
+	size_t mask;
+	alignas(64) std::atomic<size_t> enqueuePosition;
+	alignas(64) std::atomic<size_t> dequeuePosition;
+};
+
+/* Потоковая генерация выборки: потоки-генераторы заполняют блоки фиксированного размера,
+   а записывающий поток сохраняет их в файл параллельно с генерацией */
+class SelectionPipeline {
+public:
+	SelectionPipeline(const IDistribution& _d, int _threads = 0, int _blockSize = 65536, int _blocks = 0, uint64_t _seed = 1);
+
+	/* Генерация выборки объема n с сохранением в файл в формате эмпирического распределения */
+	void save(long long n, std::ofstream& file, int k = 1);
+	/* Генерация выборки объема n с сохранением данных для построения графика плотности */
+	void saveDataGraph(long long n, std::ofstream& file);
+
+private:
+	const IDistribution& d;
+	int threads;
+	int blockSize;
+	int blocks;
+	uint64_t seed;
+	/* Наибольшая длина записи числа double в кратчайшем виде */
+	static const int maxNumberLength = 24;
+	/* Блок сгенерированных значений, отформатированный генератором в текст для записи в файл */
+	struct Block {
+		std::vector<double> values;
+		std::vector<char> text;
+		size_t length;
+	};
+	/* Ожидание при пустой или заполненной очереди: сначала уступка процессора, затем сон с растущей длительностью */
+	static void backoff(int& attempt);
+	/* Запуск генераторов и запись блоков по мере их готовности */
+	void run(long long n, std::ofstream& file, bool withDensity);
+};
+
+#endif // !__SELECTION_PIPELINE_H
@@ -2,6 +2,10 @@
 #include "johnson_dist.h"
 #include "empirical_dist.h"
 #include "mixture_dist.cpp"
+#include "selection_pipeline.h"
+#include "bootstrap.h"
+#include "parameter_sweep.h"
+#include "external_empirical_dist.h"
 
 
 TEST_CASE("[Johnson Distribution] Standart Distribution") {
@@ -42,4 +46,347 @@ TEST_CASE("[Mixture Distribution] Non-Trivial Case") {
     CHECK(round(d.calculateVariance() * 1000) / 1000 == 1.187);
     CHECK(round(d.calculateCoeffAsymmetry() * 1000) / 1000 == 0.212);
     CHECK(round(d.calculateCoeffKurtosis() * 1000) / 1000 == 0.384);
-}
\ No newline at end of file
+}
+
+TEST_CASE("[Empirical Distribution] Distribution Function And Quantiles") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    EmpiricalDistribution ed(1000, d);
+    std::vector<double> selection = ed.getSelection();
+    CHECK(ed.calculateDistributionFunction(selection[0] - 1) == 0);
+    CHECK(ed.calculateDistributionFunction(selection[999]) == 1);
+    CHECK(ed.calculateDistributionFunction(selection[499]) == 0.5);
+    CHECK(ed.calculateQuantile(0.0) == selection[0]);
+    CHECK(ed.calculateQuantile(0.5) == selection[499]);
+    CHECK(ed.calculateQuantile(1.0) == selection[999]);
+    CHECK_THROWS(ed.calculateQuantile(1.5));
+    CHECK_THROWS(ed.calculateQuantile(NAN));
+    CHECK_THROWS(ed.calculateDistributionFunction(std::vector<double>{ 0, NAN }));
+
+    std::vector<double> x;
+    for (int i = 0; i < 5000; i++) {
+        x.push_back(selection[(i * 7919) % 1000] + (i % 3 - 1) * 1e-9);
+    }
+    std::vector<double> f = ed.calculateDistributionFunction(x);
+    bool same = true;
+    for (int i = 0; i < x.size(); i++) {
+        same = same && f[i] == ed.calculateDistributionFunction(x[i]);
+    }
+    CHECK(same);
+    std::vector<double> q = ed.calculateQuantile(std::vector<double>{ 0.25, 0.5, 0.75 });
+    CHECK(q[0] == selection[249]);
+    CHECK(q[2] == selection[749]);
+}
+
+
+TEST_CASE("[Empirical Distribution] Deferred Radix Sort") {
+    JohnsonDistribution d = JohnsonDistribution(1.5, -1, 3);
+    EmpiricalDistribution ed(5000, d);
+    double M = ed.calculateMathExpectation();
+    std::vector<double> selection = ed.getSelection();
+    std::vector<double> expected = selection;
+    sort(expected.begin(), expected.end());
+    CHECK(selection == expected);
+    CHECK(selection[0] < 0);
+    CHECK(round(ed.calculateMathExpectation() * 1e9) == round(M * 1e9));
+
+    double sum = 0;
+    std::vector<double> frequencies = ed.getFrequencies();
+    for (auto& f : frequencies) {
+        sum += f;
+    }
+    CHECK(round(sum * (selection[4999] - selection[0]) / ed.getK() * 1000) / 1000 == 1);
+}
+
+
+TEST_CASE("[Empirical Distribution] Histogram Cache For k") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    EmpiricalDistribution ed(2000, d, 5);
+    CHECK(ed.getK() == 5);
+    std::vector<double> frequencies5 = ed.getFrequencies();
+    std::vector<double> boundaries5 = ed.getBoundaries();
+    ed.setK(12);
+    CHECK(ed.getK() == 12);
+    std::vector<double> frequencies12 = ed.getFrequencies();
+    CHECK(frequencies12 != frequencies5);
+    ed.setK(5);
+    CHECK(ed.getK() == 5);
+    CHECK(ed.getFrequencies() == frequencies5);
+    CHECK(ed.getBoundaries() == boundaries5);
+    ed.setK(1);
+    CHECK(ed.getK() == 12);
+    CHECK(ed.getFrequencies() == frequencies12);
+    EmpiricalDistribution copy(ed);
+    copy.setK(5);
+    CHECK(copy.getFrequencies() == frequencies5);
+}
+
+
+TEST_CASE("[Selection Pipeline] Streaming Generation") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    SelectionPipeline pipeline(d, 3, 1000);
+    std::ofstream out("pipeline_test.txt");
+    pipeline.save(10500, out);
+    out.close();
+    std::ifstream in("pipeline_test.txt");
+    EmpiricalDistribution ed(in);
+    in.close();
+    CHECK(ed.getN() == 10500);
+    CHECK(round(ed.calculateMathExpectation()) == 1);
+
+    SelectionPipeline resampler(ed, 4, 256);
+    std::ofstream resampled("pipeline_test.txt");
+    resampler.save(3000, resampled);
+    resampled.close();
+    std::ifstream resampledIn("pipeline_test.txt");
+    CHECK(EmpiricalDistribution(resampledIn).getN() == 3000);
+
+    std::ofstream graph("pipeline_graph_test.txt");
+    pipeline.saveDataGraph(3000, graph);
+    graph.close();
+    std::ifstream graphIn("pipeline_graph_test.txt");
+    int lines = 0;
+    double x, f;
+    bool positive = true;
+    while (graphIn >> x >> f) {
+        positive = positive && f >= 0;
+        lines++;
+    }
+    CHECK(lines == 3000);
+    CHECK(positive);
+}
+
+
+TEST_CASE("[Bootstrap] Moment Confidence Intervals") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    EmpiricalDistribution ed(2000, d);
+    ThreadPool pool(4);
+    Bootstrap bootstrap(pool, 7);
+    MomentIntervals intervals = bootstrap.calculateIntervals(ed, 400);
+    CHECK(intervals.mathExpectation.lower < ed.calculateMathExpectation());
+    CHECK(intervals.mathExpectation.upper > ed.calculateMathExpectation());
+    CHECK(intervals.variance.lower < ed.calculateVariance());
+    CHECK(intervals.variance.upper > ed.calculateVariance());
+    CHECK(intervals.coeffAsymmetry.lower < intervals.coeffAsymmetry.upper);
+    CHECK(intervals.coeffKurtosis.lower < intervals.coeffKurtosis.upper);
+    CHECK_THROWS(bootstrap.calculateIntervals(ed, 1));
+
+    ThreadPool otherPool(3);
+    Bootstrap other(otherPool, 7);
+    for (int run = 0; run < 3; run++) {
+        MomentIntervals repeated = other.calculateIntervals(ed, 400);
+        CHECK(repeated.variance.lower == intervals.variance.lower);
+        CHECK(repeated.coeffKurtosis.upper == intervals.coeffKurtosis.upper);
+    }
+}
+
+
+TEST_CASE("[Parameter Sweep] Deterministic Cells") {
+    JohnsonDistribution second = JohnsonDistribution(3, 2, 3);
+    std::string output[2];
+    for (int threads = 1; threads <= 4; threads += 3) {
+        ThreadPool pool(threads);
+        ParameterSweep sweep(pool, second, 11);
+        sweep.addGrid({ 1.5, 2.5 }, { 0, 1 }, { 2 }, { 500, 2000 }, { 1 }, { 0, 0.5 });
+        CHECK(sweep.getCellsCount() == 16);
+        std::ofstream out("sweep_test.csv");
+        sweep.run(out);
+        out.close();
+        std::ifstream in("sweep_test.csv");
+        std::string line;
+        int lines = 0;
+        while (std::getline(in, line)) {
+            output[threads / 4] += line + "\n";
+            lines++;
+        }
+        CHECK(lines == 17);
+    }
+    CHECK(output[0] == output[1]);
+
+    ThreadPool pool(2);
+    ParameterSweep sweep(pool, second);
+    CHECK_THROWS(sweep.addCell({ -1, 0, 1, 100, 1, 0.5 }));
+}
+
+
+TEST_CASE("[Empirical Distribution] Single-Precision Storage") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    setRandomSeed(3);
+    EmpiricalDistribution ed(5000, d);
+    setRandomSeed(3);
+    FloatEmpiricalDistribution fed(5000, d);
+    CHECK(round(fed.calculateMathExpectation() * 1000) == round(ed.calculateMathExpectation() * 1000));
+    CHECK(round(fed.calculateVariance() * 1000) == round(ed.calculateVariance() * 1000));
+    CHECK(round(fed.calculateCoeffKurtosis() * 100) == round(ed.calculateCoeffKurtosis() * 100));
+    CHECK(fed.getFrequencies().size() >= fed.getK());
+
+    std::vector<float> selection = fed.getSelection();
+    CHECK(std::is_sorted(selection.begin(), selection.end()));
+    CHECK(fed.calculateQuantile(0.5) == (float)ed.calculateQuantile(0.5));
+
+    ThreadPool pool(2);
+    Bootstrap bootstrap(pool);
+    MomentIntervals intervals = bootstrap.calculateIntervals(fed, 200);
+    CHECK(intervals.mathExpectation.lower < fed.calculateMathExpectation());
+    CHECK(intervals.mathExpectation.upper > fed.calculateMathExpectation());
+}
+
+
+TEST_CASE("[Mixture Distribution] Nested Mixture Moments") {
+    JohnsonDistribution d1 = JohnsonDistribution(2.5, 1, 2);
+    JohnsonDistribution d2 = JohnsonDistribution(3, 2, 3);
+    MixtureDistribution<JohnsonDistribution, JohnsonDistribution> inner(d1, d2, 0.5);
+    MixtureDistribution<MixtureDistribution<JohnsonDistribution, JohnsonDistribution>, JohnsonDistribution> d(inner, d1, 0);
+    Moments moments = d.calculateMoments();
+    CHECK(moments.mathExpectation == 1.5);
+    CHECK(round(moments.variance * 1000) / 1000 == 1.187);
+    CHECK(round(moments.coeffAsymmetry * 1000) / 1000 == 0.212);
+    CHECK(round(d.calculateCoeffKurtosis() * 1000) / 1000 == 0.384);
+
+    d.component1().setP(1);
+    CHECK(d.calculateMathExpectation() == 2);
+    CHECK(round(d.calculateVariance() * 1000) / 1000 == round(d2.calculateVariance() * 1000) / 1000);
+    d.component1().component2().setShift(4);
+    CHECK(d.calculateMathExpectation() == 4);
+    d.setP(1);
+    CHECK(d.calculateMathExpectation() == 1);
+
+    MixtureDistribution<JohnsonDistribution, JohnsonDistribution> m(d1, d2, 0.5);
+    auto& c = m.component2();
+    CHECK(m.calculateMathExpectation() == 1.5);
+    c.setShift(10);
+    CHECK(m.calculateMathExpectation() == 5.5);
+
+    MixtureDistribution<MixtureDistribution<JohnsonDistribution, JohnsonDistribution>, JohnsonDistribution> outer(m, d1, 0);
+    auto& inner2 = outer.component1().component2();
+    CHECK(outer.calculateMathExpectation() == 5.5);
+    inner2.setShift(2);
+    CHECK(outer.calculateMathExpectation() == 1.5);
+
+    std::vector<std::thread> threads;
+    std::atomic<int> correct(0);
+    for (int i = 0; i < 4; i++) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < 1000; j++) {
+                correct += outer.calculateMoments().mathExpectation == 1.5;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    CHECK(correct == 4000);
+}
+
+TEST_CASE("[Empirical Distribution] Moments In One Call") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    EmpiricalDistribution ed(3000, d);
+    Moments moments = ed.calculateMoments();
+    CHECK(moments.mathExpectation == ed.calculateMathExpectation());
+    CHECK(round(moments.variance * 1e9) == round(ed.calculateVariance() * 1e9));
+    CHECK(round(moments.coeffAsymmetry * 1e9) == round(ed.calculateCoeffAsymmetry() * 1e9));
+    CHECK(round(moments.coeffKurtosis * 1e9) == round(ed.calculateCoeffKurtosis() * 1e9));
+}
+
+
+TEST_CASE("[External Empirical Distribution] Matches In-Memory Distribution") {
+    JohnsonDistribution d = JohnsonDistribution(1.5, -1, 3);
+    EmpiricalDistribution source(20000, d, 9);
+    std::ofstream out("external_test.txt");
+    source.save(out);
+    out.close();
+
+    std::ifstream in("external_test.txt");
+    EmpiricalDistribution ed(in);
+    in.close();
+    std::ifstream externalIn("external_test.txt");
+    ExternalEmpiricalDistribution eed(externalIn, ".", 3000);
+    externalIn.close();
+
+    std::vector<double> selection = ed.getSelection();
+    CHECK(eed.getN() == ed.getN());
+    CHECK(eed.getK() == ed.getK());
+    CHECK(eed.getBoundaries() == ed.getBoundaries());
+    CHECK(eed.getFrequencies() == ed.getFrequencies());
+    CHECK(eed.calculateMathExpectation() == ed.calculateMathExpectation());
+    CHECK(eed.calculateVariance() == ed.calculateVariance());
+    CHECK(eed.calculateCoeffAsymmetry() == ed.calculateCoeffAsymmetry());
+    CHECK(eed.calculateCoeffKurtosis() == ed.calculateCoeffKurtosis());
+    CHECK(eed.calculateMoments().coeffKurtosis == ed.calculateMoments().coeffKurtosis);
+
+    std::vector<double> p = { 0, 0.001, 0.25, 0.5, 0.999, 1 };
+    CHECK(eed.calculateQuantile(p) == ed.calculateQuantile(p));
+    CHECK(eed.calculateDistributionFunction(selection) == ed.calculateDistributionFunction(selection));
+    CHECK(eed.calculateDensity(selection[12345]) == ed.calculateDensity(selection[12345]));
+
+    eed.setK(4);
+    ed.setK(4);
+    CHECK(eed.getFrequencies() == ed.getFrequencies());
+
+    std::ifstream truncated("external_test.txt");
+    std::ofstream broken("external_broken_test.txt");
+    std::string line;
+    for (int i = 0; i < 10000 && std::getline(truncated, line); i++) {
+        broken << line << "\n";
+    }
+    broken.close();
+    std::ifstream brokenIn("external_broken_test.txt");
+    CHECK_THROWS(ExternalEmpiricalDistribution(brokenIn, ".", 3000));
+    CHECK(std::ifstream("external_test.txt").good());
+}
+
+TEST_CASE("[External Empirical Distribution] Multi-Pass Merge") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    EmpiricalDistribution source(20000, d, 9);
+    std::ofstream out("external_merge_test.txt");
+    source.save(out);
+    out.close();
+
+    std::ifstream in("external_merge_test.txt");
+    EmpiricalDistribution ed(in);
+    in.close();
+    std::vector<double> selection = ed.getSelection();
+    std::vector<double> p = { 0, 0.001, 0.25, 0.5, 0.999, 1 };
+
+    for (long long chunkSize : { 100, 4 }) {
+        std::ifstream externalIn("external_merge_test.txt");
+        ExternalEmpiricalDistribution eed(externalIn, ".", chunkSize);
+        externalIn.close();
+        CHECK(eed.getN() == ed.getN());
+        CHECK(eed.getBoundaries() == ed.getBoundaries());
+        CHECK(eed.getFrequencies() == ed.getFrequencies());
+        CHECK(eed.calculateMoments().variance == ed.calculateMoments().variance);
+        CHECK(eed.calculateQuantile(p) == ed.calculateQuantile(p));
+        CHECK(eed.calculateDistributionFunction(selection) == ed.calculateDistributionFunction(selection));
+    }
+}
+
+
+TEST_CASE("[Random] Distinct Default Thread Streams") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    double x1 = 0, x2 = 0;
+    std::thread t1([&]() { x1 = d.getRandomVariable(); });
+    t1.join();
+    std::thread t2([&]() { x2 = d.getRandomVariable(); });
+    t2.join();
+    CHECK(x1 != x2);
+
+    double y1 = 0, y2 = 0;
+    std::thread t3([&]() { setRandomSeed(5); y1 = d.getRandomVariable(); });
+    t3.join();
+    std::thread t4([&]() { setRandomSeed(5); y2 = d.getRandomVariable(); });
+    t4.join();
+    CHECK(y1 == y2);
+}
+
+
+TEST_CASE("[Empirical Distribution] Sampling From Histogram") {
+    JohnsonDistribution d = JohnsonDistribution(2.5, 1, 2);
+    EmpiricalDistribution ed(20000, d);
+    EmpiricalDistribution resampled(20000, ed);
+    std::vector<double> selection = ed.getSelection();
+    std::vector<double> values = resampled.getSelection();
+    CHECK(values[0] >= selection[0]);
+    CHECK(values[19999] <= ed.getBoundaries().back());
+    CHECK(fabs(resampled.calculateMathExpectation() - ed.calculateMathExpectation()) < 0.05);
+    CHECK(ed.calculateDensity(selection[19999] + 1) == 0);
+}
@@ -0,0 +1,121 @@
+﻿#include "thread_pool.h"
+
+ThreadPool::ThreadPool(int _threads) :
+	nextQueue(0), queued(0), unfinished(0), stop(false) {
+	if (_threads <= 0) {
+		_threads = (int)std::thread::hardware_concurrency();
+	}
+	if (_threads <= 0) {
+		_threads = 1;
+	}
+	for (int i = 0; i < _threads; i++) {
+		queues.emplace_back(new Queue());
+	}
+	for (int i = 0; i < _threads; i++) {
+		workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+}
+
+int ThreadPool::getThreads() const {
+	return (int)workers.size();
+}
+
+void ThreadPool::submit(std::function<void(int)> task) {
+	unfinished++;
+	Queue& queue = *queues[nextQueue++ % queues.size()];
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queued++;
+	}
+	sleepCondition.notify_one();
+}
+
+bool ThreadPool::takeTask(int worker, std::function<void(int)>& task) {
+	{
+		Queue& queue = *queues[worker];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			return true;
+		}
+	}
+	for (int i = 1; i < queues.size(); i++) {
+		Queue& queue = *queues[(worker + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.tasks.empty()) {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::workerLoop(int worker) {
+	for (;;) {
+		std::function<void(int)> task;
+		if (takeTask(worker, task)) {
+			queued--;
+			try {
+				task(worker);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> lock(doneMutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+			}
+			if (--unfinished == 0) {
+				std::lock_guard<std::mutex> lock(doneMutex);
+				doneCondition.notify_all();
+			}
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepCondition.wait(lock, [this]() { return stop || queued > 0; });
+		if (stop && queued == 0) {
+			return;
+		}
+	}
+}
+
+void ThreadPool::wait() {
+	std::unique_lock<std::mutex> lock(doneMutex);
+	doneCondition.wait(lock, [this]() { return unfinished == 0; });
+	if (error) {
+		std::exception_ptr e = error;
+		error = nullptr;
+		std::rethrow_exception(e);
+	}
+}
+
+void ThreadPool::parallelFor(long long count, const std::function<void(long long, int)>& task, long long grain) {
+	if (grain < 1) {
+		grain = 1;
+	}
+	for (long long begin = 0; begin < count; begin += grain) {
+		long long end = std::min(begin + grain, count);
+		submit([&task, begin, end](int worker) {
+			for (long long i = begin; i < end; i++) {
+				task(i, worker);
+			}
+		});
+	}
+	wait();
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stop = true;
+	}
+	sleepCondition.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
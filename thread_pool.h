@@ -0,0 +1,53 @@
+﻿#ifndef __THREAD_POOL_H
+#define __THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Пул потоков с очередью задач у каждого потока и перехватом задач у соседей */
+class ThreadPool {
+public:
+	ThreadPool(int _threads = 0);
+	ThreadPool(const ThreadPool& pool) = delete;
+	ThreadPool& operator=(const ThreadPool& pool) = delete;
+
+	/* Функция для получения числа потоков */
+	int getThreads() const;
+	/* Постановка задачи в очередь, задача получает номер исполняющего потока */
+	void submit(std::function<void(int)> task);
+	/* Ожидание завершения всех поставленных задач */
+	void wait();
+	/* Параллельное выполнение task(i, worker) для i из [0; count) порциями по grain индексов */
+	void parallelFor(long long count, const std::function<void(long long, int)>& task, long long grain = 1);
+	~ThreadPool();
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<std::function<void(int)>> tasks;
+	};
+	std::vector<std::unique_ptr<Queue>> queues;
+	std::vector<std::thread> workers;
+	std::atomic<int> nextQueue;
+	std::atomic<long long> queued;
+	std::atomic<long long> unfinished;
+	bool stop;
+	std::mutex sleepMutex;
+	std::condition_variable sleepCondition;
+	std::mutex doneMutex;
+	std::condition_variable doneCondition;
+	std::exception_ptr error;
+	/* Извлечение задачи из своей очереди или перехват из чужой */
+	bool takeTask(int worker, std::function<void(int)>& task);
+	/* Основной цикл рабочего потока */
+	void workerLoop(int worker);
+};
+
+#endif // !__THREAD_POOL_H